@@ -11,7 +11,16 @@ content: genodians.tar
 
 genodians.tar:
 	tar cf genodians.tar -C $(REP_DIR) \
-	       Makefile authors style tool/gosh/gosh tool/gosh/html.gosh
+	       Makefile authors style tool/gosh/gosh tool/gosh/html.gosh \
+	       tool/zlib.tcl tool/png.tcl \
+	       tool/timed_shell tool/build_timing.tcl tool/storage_usage.tcl \
+	       tool/search_index.tcl
+
+# initial website restored at boot, see 'website.tar' rule of the Makefile
+content: website.tar
+
+website.tar:
+	tar cf $@ --files-from /dev/null
 
 # list of known authors
 AUTHORS := $(notdir $(wildcard $(REP_DIR)/authors/*))
@@ -39,6 +48,7 @@ fetchurl.config:
 
 define FETCHURL_CONFIG_HEAD
 	<config verbose="no" ignore_failures="yes">
+		<report progress="yes" delay_ms="1000"/>
 		<vfs>
 			<dir name="dev">
 				<log/> <null/> <inline name="rtc">2000-01-01 00:00</inline>
@@ -12,1181 +12,20 @@
  */
 
 /* Genode includes */
-#include <base/attached_rom_dataspace.h>
 #include <base/component.h>
 #include <base/heap.h>
-#include <os/buffered_xml.h>
 #include <os/path.h>
-#include <os/reporter.h>
-#include <rtc_session/connection.h>
-#include <timer_session/connection.h>
+#include <root/component.h>
 
-/* sculpt_manager includes */
-#include <model/child_exit_state.h>
-#include <model/child_state.h>
+/* local includes */
+#include <genodians/access_log.h>
+#include <genodians/import.h>
+#include <genodians/latency_probe.h>
+#include <genodians/lighttpd.h>
+#include <genodians/text_reporter.h>
+#include <genodians/traffic_rates.h>
 
-/* musl includes */
-#include <tm.h>
-
-
-namespace Utils {
-	using namespace Genode;
-
-	struct Seconds {
-
-		uint64_t value;
-
-		void print(Output &out) const
-		{
-			unsigned const d  = unsigned(value / 86400);
-			unsigned const dr = unsigned(value % 86400);
-			unsigned const h  = unsigned(dr / 3600);
-			unsigned const m  = unsigned(dr / 60 % 60);
-			unsigned const s  = unsigned(dr % 60);
-
-			if (d) Genode::print(out, d, " day",    d > 1 ? "s " : " ");
-			if (h) Genode::print(out, h, " hour",   h > 1 ? "s " : " ");
-			if (m) Genode::print(out, m, " minute", m > 1 ? "s " : " ");
-			if (s) Genode::print(out, s, " second", s > 1 ? "s"  : "");
-
-			if (!(d||h||m||s)) Genode::print(out, "0 seconds");
-		}
-
-		static Seconds from_rtc(Rtc::Timestamp const &);
-
-		Seconds diff(Seconds const &other) const
-		{
-			return { other.value - value };
-		}
-	};
-
-	Rtc::Timestamp from_seconds(Seconds const&);
-
-	using Date = String<21>;
-	Date from_rtc(Rtc::Timestamp const &ts)
-	{
-		bool const iso_8601 = true;
-
-		bool const pad_month  = ts.month  < 10;
-		bool const pad_day    = ts.day    < 10;
-		bool const pad_hour   = ts.hour   < 10;
-		bool const pad_minute = ts.minute < 10;
-		bool const pad_second = ts.second < 10;
-
-		return Date(ts.year, "-",
-		            pad_month  ? "0" : "", ts.month,  "-",
-		            pad_day    ? "0" : "", ts.day,    iso_8601 ? "T" : " ",
-		            pad_hour   ? "0" : "", ts.hour,   ":",
-		            pad_minute ? "0" : "", ts.minute, ":",
-		            pad_second ? "0" : "", ts.second, iso_8601 ? "Z" : "");
-	}
-
-	namespace Html {
-		using String = String<64>;
-		void gen_section_div(Xml_generator &xml, char const *name, auto const &fn);
-		void gen_table_body(Xml_generator &xml, auto const &fn);
-		void gen_table_key_value_row(Xml_generator &, Html::String const &, Html::String const &);
-	} /* namespace Html */
-} /* namespace Utils */
-
-
-Utils::Seconds Utils::Seconds::from_rtc(Rtc::Timestamp const &rtc)
-{
-	struct tm tm;
-	Genode::memset(&tm, 0, sizeof(struct tm));
-	tm.tm_sec  = rtc.second;
-	tm.tm_min  = rtc.minute;
-	tm.tm_hour = rtc.hour;
-	tm.tm_mday = rtc.day;
-	tm.tm_mon  = rtc.month - 1;
-	tm.tm_year = rtc.year - 1900;
-
-	return Seconds { .value = Genode::uint64_t(tm_to_secs(&tm)) };
-}
-
-
-Rtc::Timestamp Utils::from_seconds(Utils::Seconds const &seconds)
-{
-	struct tm tm;
-	Genode::memset(&tm, 0, sizeof(tm));
-
-	int const err = secs_to_tm(seconds.value, &tm);
-	if (err)
-		return Rtc::Timestamp();
-
-	return Rtc::Timestamp {
-		.microsecond = 0,
-		.second = (unsigned)tm.tm_sec,
-		.minute = (unsigned)tm.tm_min,
-		.hour   = (unsigned)tm.tm_hour,
-		.day    = (unsigned)tm.tm_mday,
-		.month  = (unsigned)tm.tm_mon  + 1,
-		.year   = (unsigned)tm.tm_year + 1900,
-	};
-}
-
-
-void Utils::Html::gen_section_div(Xml_generator &xml, char const *name, auto const &fn)
-{
-	xml.node("div", [&] {
-		xml.attribute("id", name);
-		xml.node("h3", [&] { xml.append(name); });
-		fn(xml); });
-}
-
-
-void Utils::Html::gen_table_body(Xml_generator &xml, auto const &fn) {
-	xml.node("table", [&] { xml.node("tbody", [&] { fn(xml); }); }); }
-
-
-void Utils::Html::gen_table_key_value_row(Xml_generator &xml, Utils::Html::String const &key,
-                                                              Utils::Html::String const &value)
-{
-	xml.node("tr", [&] {
-		xml.node("td", [&] { xml.append(key.string()); });
-		xml.node("td", [&] { xml.append(value.string()); });
-	});
-}
-
-
-/*
- * Extend helper utilities from Sculpt
- */
-namespace Sculpt {
-	void gen_default_route_parent(Generator &g)
-	{
-		g.node("default-route", [&] {
-			g.node("any-service", [&] {
-				g.node("parent", [&] { }); }); });
-	}
-
-	void gen_common_parent_routes(Generator &g)
-	{
-		gen_service_node<Rom_session>(g, [&] { g.node("parent", [&] {}); });
-		gen_service_node<Cpu_session>(g, [&] { g.node("parent", [&] {}); });
-		gen_service_node<Pd_session> (g, [&] { g.node("parent", [&] {}); });
-		gen_service_node<Rm_session> (g, [&] { g.node("parent", [&] {}); });
-		gen_service_node<Log_session>(g, [&] { g.node("parent", [&] {}); });
-	}
-
-	void gen_arg(Generator &g, auto const &arg) {
-		g.node("arg", [&] { g.attribute("value", arg); }); }
-
-	void gen_named_dir(Generator &g, char const *name, auto const &fn)
-	{
-		g.node("dir", [&] {
-			g.attribute("name", name);
-			fn(g); });
-	}
-
-	void gen_symlink(Generator &g, char const *name, char const *target)
-	{
-		g.node("symlink", [&] {
-			g.attribute("name", name);
-			g.attribute("target", target); });
-	}
-
-	void gen_rom(Generator &g, char const *name)
-	{
-		g.node("rom", [&] {
-			g.attribute("name", name);
-			g.attribute("binary", "no"); });
-	}
-
-	void gen_heartbeat_node(Generator &g, unsigned rate_ms) {
-		g.node("heartbeat", [&] { g.attribute("rate_ms", rate_ms); }); }
-} /* namespace Sculpt */
-
-
-namespace Genodians {
-	using namespace Genode;
-	using namespace Sculpt;
-	using namespace Utils;
-
-	struct Notify_interface : Interface
-	{
-		virtual void notify() const = 0;
-	};
-
-	/*
-	 * The Managed_init interface provides mechanisms for
-	 * monitoring and updating the managed init.
-	 */
-	struct Managed_init : Interface
-	{
-		Allocator &_alloc;
-
-		Notify_interface &_state_change_notifier;
-
-		using Child_state_registery = Registry<Child_state>;
-		Child_state_registery child_states { };
-
-		bool _evalute_child_states(Node const &state)
-		{
-			/* upgrade RAM and cap quota on demand */
-			bool reconfigure = false;
-			state.for_each_sub_node("child", [&] (Node const &child) {
-				bool reconfiguration_needed = false;
-				child_states.for_each([&] (Child_state &child_state) {
-					if (child_state.apply_child_state_report(child))
-						reconfiguration_needed = true; });
-				if (reconfiguration_needed)
-					reconfigure = true;
-			});
-			return reconfigure;
-		}
-
-		Constructible<Buffered_node> _cached_state_report { };
-
-		bool _update_cached_state_report(Node const &node)
-		{
-			_cached_state_report.construct(_alloc, node);
-			return true;
-		}
-
-		Rom_handler<Managed_init> _state_rom;
-
-		void _state_update(Node const &node) {
-
-			if (Managed_init::_update_cached_state_report(node))
-				_state_change_notifier.notify();
-
-			state_update(node, _evalute_child_states(node)); }
-
-		Expanding_reporter _config_reporter;
-
-		Managed_init(Env &env, Allocator &alloc, Notify_interface &notify,
-		             char const *state_name, char const *config_name)
-		:
-			_alloc                 { alloc },
-			_state_change_notifier { notify },
-			_state_rom             { env, state_name, *this,
-			                         &Managed_init::_state_update },
-			_config_reporter       { env, "config", config_name }
-		{ }
-
-		void generate_config(auto const &fn)
-		{
-			_config_reporter.generate([&] (Generator &g) {
-				fn(g); });
-		}
-
-		void with_cached_state_report(auto const &avail_fn,
-		                              auto const &missing_fn) const
-		{
-			if (_cached_state_report.constructed())
-				avail_fn(*_cached_state_report);
-			else
-				missing_fn();
-		}
-
-		/****************************
-		 ** Managed_init interface **
-		 ****************************/
-
-		virtual void generate_report(Xml_generator &)    const = 0;
-		virtual void state_update   (Node const &, bool)       = 0;
-	};
-
-	struct Import;
-	struct Lighttpd;
-
-	/*
-	 * The Managed_child interface streamlines the generation
-	 * of the configuration for each step of the import process
-	 * and provides a convenience state checker.
-	 *
-	 */
-	struct Managed_child : Interface
-	{
-		struct Ok    { bool finished;   };
-		struct Error { int  exit_value; };
-
-		using Result = Attempt<Ok, Error>;
-
-		Child_state _child_state;
-
-		Managed_child(Managed_init::Child_state_registery &registry,
-		              char const *name, Priority priority,
-		              Ram_quota ram, Cap_quota caps)
-		:
-			_child_state { registry, name, priority, ram, caps }
-		{ }
-
-		virtual ~Managed_child() { }
-
-		Result check(Node const &state_node)
-		{
-			Child_exit_state const exit_state(state_node, name());
-
-			if (!exit_state.responsive)
-				return Error { .exit_value = -42 };
-			if (!exit_state.exited)
-				return Ok { .finished = false };
-			if (exit_state.code != 0) {
-				error(name(), " exited with value ", exit_state.code);
-				return Error { .exit_value = exit_state.code };
-			}
-			return Ok { .finished = true };
-		}
-
-		void gen_start_node_content(Generator &g) const {
-			_child_state.gen_start_node_content(g); }
-
-		void trigger_restart() {
-			_child_state.trigger_restart(); }
-
-		Start_name const name() const {
-			return _child_state.name(); }
-
-		/*****************************
-		 ** Managed_child interface **
-		 *****************************/
-
-		virtual void  generate(Generator &g) const = 0;
-	};
-
-	struct Fetch;
-	struct Wipe;
-	struct Extract;
-	struct Generate;
-
-	struct Config
-	{
-		struct Child
-		{
-			Ram_quota ram;
-			Cap_quota caps;
-
-			static Child from_node(Node const &node)
-			{
-				return Child {
-					.ram = Ram_quota {
-						node.attribute_value("ram", Number_of_bytes(48u << 20)) },
-					.caps = Cap_quota {
-						node.attribute_value("caps", 300u) }
-				};
-			}
-		};
-
-		struct Lighttpd
-		{
-			Child    lighttpd;
-			unsigned heartbeat_ms;
-		};
-
-		struct Import
-		{
-			Child    fetchurl;
-			Child    wipe;
-			Child    extract;
-			Child    generate;
-			unsigned sleep_duration;
-			unsigned heartbeat_ms;
-		};
-
-		unsigned status_update_interval;
-
-		Lighttpd lighttpd_config;
-		Import   import_config;
-
-		static Config update_from_node(Node const &config_node)
-		{
-			unsigned const status_update_interval =
-				config_node.attribute_value("status_update_interval_sec", 60u);
-
-			Child const lighttpd =
-				config_node.with_sub_node("lighttpd",
-					[&] (Node const &node) { return Child::from_node(node); },
-					[&]                    { return Child::from_node(Node()); });
-			unsigned const lighttpd_heartbeat_ms =
-				config_node.with_sub_node("lighttpd",
-					[&] (Node const &node) { return node.attribute_value("heartbeat_ms", 3000u); },
-					[&]                    { return 3000u; });
-
-			Import const import_config =
-				config_node.with_sub_node("import",
-					[&] (Node const &node) {
-
-						unsigned const import_heartbeat_ms =
-							node.attribute_value("heartbeat_ms", 3000u);
-						unsigned const sleep_duration =
-							node.attribute_value("update_interval_min", 180u);
-
-						Child const fetchurl =
-							node.with_sub_node("fetchurl",
-								[&] (Node const &node) { return Child::from_node(node); },
-								[&]                    { return Child::from_node(Node()); });
-						Child const wipe =
-							node.with_sub_node("wipe",
-								[&] (Node const &node) { return Child::from_node(node); },
-								[&]                    { return Child::from_node(Node()); });
-						Child const extract =
-							node.with_sub_node("extract",
-								[&] (Node const &node) { return Child::from_node(node); },
-								[&]                    { return Child::from_node(Node()); });
-						Child const generate =
-							node.with_sub_node("generate",
-								[&] (Node const &node) { return Child::from_node(node); },
-								[&]                    { return Child::from_node(Node()); });
-
-						return Import {
-							.fetchurl       = fetchurl,
-							.wipe           = wipe,
-							.extract        = extract,
-							.generate       = generate,
-							.sleep_duration = sleep_duration,
-							.heartbeat_ms   = import_heartbeat_ms
-						};
-					},
-					[&] { return Import { }; });
-
-			return Config {
-				.status_update_interval = status_update_interval,
-				.lighttpd_config = Lighttpd {
-					.lighttpd     = lighttpd,
-					.heartbeat_ms = lighttpd_heartbeat_ms
-				},
-				.import_config   = import_config
-			};
-		}
-	};
-
-	struct Main;
-} /* namespace Genodians */
-
-
-struct Genodians::Fetch : Genodians::Managed_child
-{
-	Fetch(Managed_init::Child_state_registery &registry,
-	      Config::Child                 const &config)
-	:
-		Managed_child { registry, "fetchurl",
-		                Priority  { 0 },
-		                config.ram, config.caps }
-	{ }
-
-	/*****************************
-	 ** Managed_child interface **
-	 *****************************/
-
-	void generate(Generator &g) const override
-	{
-		g.node("start", [&] {
-			gen_start_node_content(g);
-
-			g.node("heartbeat", [&] { });
-
-			g.node("route", [&] {
-				gen_service_node<Rom_session>(g, [&] {
-					g.attribute("label", "config");
-					g.node("parent", [&] {
-						g.attribute("label", "fetchurl.config"); }); });
-				gen_service_node<Nic::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_service_node<File_system::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_service_node<Timer::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_common_parent_routes(g);
-			});
-		});
-	}
-};
-
-
-struct Genodians::Wipe : Genodians::Managed_child
-{
-	Wipe(Managed_init::Child_state_registery &registry,
-	     Config::Child                 const &config)
-	:
-		Managed_child { registry, "wipe",
-		                Priority  { 0 },
-		                config.ram, config.caps }
-	{ }
-
-	/*****************************
-	 ** Managed_child interface **
-	 *****************************/
-
-	void generate(Generator &g) const override
-	{
-		g.node("start", [&] {
-			gen_start_node_content(g);
-			gen_named_node(g, "binary", "init");
-
-			g.node("heartbeat", [&] { });
-
-			g.node("route", [&] {
-				gen_service_node<Rom_session>(g, [&] {
-					g.attribute("label", "config");
-					g.node("parent", [&] {
-						g.attribute("label", "wipe.config"); }); });
-				gen_service_node<File_system::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_service_node<Timer::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_common_parent_routes(g);
-			});
-		});
-	}
-};
-
-
-struct Genodians::Extract : Genodians::Managed_child
-{
-	Extract(Managed_init::Child_state_registery &registry,
-	        Config::Child                 const &config)
-	:
-		Managed_child { registry, "extract",
-		                Priority  { 0 },
-		                config.ram, config.caps }
-	{ }
-
-	/*****************************
-	 ** Managed_child interface **
-	 *****************************/
-
-	void generate(Generator &g) const override
-	{
-		g.node("start", [&] {
-			gen_start_node_content(g);
-
-			g.node("heartbeat", [&] { });
-
-			g.node("route", [&] {
-				gen_service_node<File_system::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_service_node<Rom_session>(g, [&] {
-					g.attribute("label", "config");
-					g.node("parent", [&] {
-						g.attribute("label", "extract.config"); }); });
-				gen_common_parent_routes(g);
-			});
-		});
-	}
-};
-
-
-struct Genodians::Generate : Genodians::Managed_child
-{
-	Generate(Managed_init::Child_state_registery &registry,
-	         Config::Child                 const &config)
-	:
-		Managed_child { registry, "generate",
-		                Priority  { 0 },
-		                config.ram, config.caps }
-	{ }
-
-	/*****************************
-	 ** Managed_child interface **
-	 *****************************/
-
-	void generate(Generator &g) const override
-	{
-		g.node("start", [&] {
-			gen_start_node_content(g);
-
-			gen_named_node(g, "binary", "init");
-			g.node("heartbeat", [&] { });
-
-			g.node("route", [&] {
-				gen_service_node<Rom_session>(g, [&] {
-					g.attribute("label", "config");
-					g.node("parent", [&] {
-						g.attribute("label", "generate.config"); }); });
-				gen_service_node<File_system::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_service_node<Timer::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_service_node<Rtc::Session>(g, [&] {
-					g.node("parent", [&] { }); });
-				gen_common_parent_routes(g);
-			});
-		});
-	}
-};
-
-
-struct Genodians::Import : Genodians::Managed_init
-{
-	Env &_env;
-
-	Timer::Connection &_timer;
-	Rtc::Connection   &_rtc;
-
-	enum class State {
-		INVALID, INIT, FETCH, WIPE, EXTRACT, GENERATE, SLEEP };
-
-	State _state;
-
-	Constructible<Fetch>    _fetch    { };
-	Constructible<Wipe>     _wipe     { };
-	Constructible<Extract>  _extract  { };
-	Constructible<Generate> _generate { };
-
-	Seconds _last_fetch_duration    {  60u };
-	Seconds _last_wipe_duration     {  15u };
-	Seconds _last_extract_duration  {  15u };
-	Seconds _last_generate_duration { 180u };
-
-	/*
-	 * Step timeout handling
-	 */
-
-	Seconds _calculate_timeout(Seconds const secs,
-	                           Seconds const min = { .value = 15u }) const
-	{
-		/* some steps take normally at most a few seconds */
-		Seconds const min_duration = { max(secs.value / 2, min.value) };
-
-		return { secs.value + min_duration.value };
-	}
-
-	Seconds _step_timeout_secs { 0 };
-	bool    _step_timeout_triggered = false;
-
-	Timer::One_shot_timeout<Import> _step_timeout {
-		_timer, *this, &Import::_handle_step_timeout };
-
-	void _handle_step_timeout(Duration)
-	{
-		_step_timeout_triggered = true;
-		warning("timeout triggered for step ", (unsigned)_state);
-
-		with_cached_state_report([&] (Node const &node) {
-			state_update(node, false); }, [&] { });
-	}
-
-	/*
-	 * Sleep timeout handling
-	 */
-
-	bool _sleep_timeout_triggered = false;
-
-	Timer::One_shot_timeout<Import> _sleep_timeout {
-		_timer, *this, &Import::_handle_sleep_timeout };
-
-	void _handle_sleep_timeout(Duration)
-	{
-		_sleep_timeout_triggered = true;
-
-		with_cached_state_report([&] (Node const &node) {
-			state_update(node, false); }, [&] { });
-	}
-
-	void _update_init_config(Generator &g);
-
-	Config::Import const &_config;
-
-	Date _last_update { };
-	Date _next_update { };
-
-	Seconds  _import_start      { 0 };
-	Seconds  _import_step_start { 0 };
-	Seconds  _import_duration   { 0 };
-	unsigned _imports           = 0;
-
-	Import(Env                  &env,
-	       Allocator            &alloc,
-	       Notify_interface     &notify,
-	       Timer::Connection    &timer,
-	       Rtc::Connection      &rtc,
-	       Config::Import const &config)
-	:
-		Managed_init { env, alloc, notify,
-		               "import.state", "import.config" },
-		_env         { env },
-		_timer       { timer },
-		_rtc         { rtc },
-		_state       { State::INIT },
-		_config      { config }
-	{
-		/* initial Rom_handler signal will get us started */
-	}
-
-	/****************************
-	 ** Managed_init interface **
-	 ****************************/
-
-	void generate_report(Xml_generator &xml)     const override;
-	void state_update   (Node const &, bool)     override;
-};
-
-
-void Genodians::Import::generate_report(Xml_generator &xml) const
-{
-	Html::gen_section_div(xml, "Import", [&] (Xml_generator &xml) {
-		if (_imports) {
-			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
-				Html::gen_table_key_value_row(xml, Html::String("Total imports"),
-				                                   _imports);
-				Html::gen_table_key_value_row(xml, Html::String("Import duration"),
-				                                   _import_duration);
-				Html::gen_table_key_value_row(xml, Html::String("Last import"),
-				                                   _last_update);
-				Html::gen_table_key_value_row(xml, Html::String("Next import"),
-				                                   _next_update);
-			});
-			xml.node("p", [&] { xml.append("Last durations"); });
-			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
-				Html::gen_table_key_value_row(xml, Html::String("Fetch"),
-				                                   _last_fetch_duration);
-				Html::gen_table_key_value_row(xml, Html::String("Extract"),
-				                                   _last_extract_duration);
-				Html::gen_table_key_value_row(xml, Html::String("Wipe"),
-				                                   _last_wipe_duration);
-				Html::gen_table_key_value_row(xml, Html::String("Generate"),
-				                                   _last_generate_duration);
-			});
-		}
-
-		Managed_init::with_cached_state_report([&] (Node const &node) {
-
-			/* denote importing activity */
-			if (node.has_sub_node("child"))
-				xml.node("p", [&] {
-					if (!_imports) xml.append("initial ");
-					xml.append("import under way…"); });
-
-			xml.node("h4", [&] { xml.append("init-state-report"); });
-			xml.node("pre", [&] {
-				xml.attribute("lang", "xml");
-				xml.append_content(node); });
-		}, [&] { });
-	});
-}
-
-
-void Genodians::Import::state_update(Node const &state_node,
-                                     bool        reconfigure_init)
-{
-	Seconds const current_secs = Seconds::from_rtc(_rtc.current_time());
-
-	bool const timeout = _step_timeout_triggered;
-	_step_timeout_triggered = false;
-
-	State new_state      = State::INVALID;
-	int   new_exit_value = -1;
-
-	/*
-	 * The following section evaluates the current state - even
-	 * when a timeout happend because that is also treated like
-	 * beginning the next step.
-	 */
-
-	switch (_state) {
-	case State::INVALID:
-	{
-		break;
-	}
-	case State::INIT:
-	{
-		_import_start = current_secs;
-		new_state = State::FETCH;
-		break;
-	}
-	case State::FETCH:
-	{
-		new_state = _fetch->check(state_node).convert<State>(
-			[&] (Managed_child::Ok ok) {
-				return ok.finished ? State::WIPE : State::FETCH;
-			},
-			[&] (Managed_child::Error err) {
-				new_exit_value = err.exit_value;
-				return State::INVALID;
-			});
-
-		if (new_state != State::FETCH) {
-			_fetch.destruct();
-			if (new_state != State::INVALID)
-				_last_fetch_duration =
-					_import_step_start.diff(current_secs);
-		}
-		break;
-	}
-	case State::WIPE:
-	{
-		new_state = _wipe->check(state_node).convert<State>(
-			[&] (Managed_child::Ok ok) {
-				return ok.finished ? State::EXTRACT : State::WIPE;
-			},
-			[&] (Managed_child::Error err) {
-				new_exit_value = err.exit_value;
-				return State::INVALID;
-			});
-
-		if (new_state != State::WIPE) {
-			_wipe.destruct();
-			if (new_state != State::INVALID)
-				_last_wipe_duration = _import_step_start.diff(current_secs);
-		}
-		break;
-	}
-	case State::EXTRACT:
-	{
-		new_state = _extract->check(state_node).convert<State>(
-			[&] (Managed_child::Ok ok) {
-				return ok.finished ? State::GENERATE : State::EXTRACT;
-			},
-			[&] (Managed_child::Error err) {
-				new_exit_value = err.exit_value;
-				return State::INVALID;
-			});
-
-		if (new_state != State::EXTRACT) {
-			_extract.destruct();
-			if (new_state != State::INVALID)
-				_last_extract_duration = _import_step_start.diff(current_secs);
-		}
-		break;
-	}
-	case State::GENERATE:
-	{
-		new_state = _generate->check(state_node).convert<State>(
-			[&] (Managed_child::Ok ok) {
-				return ok.finished ? State::SLEEP : State::GENERATE;
-			},
-			[&] (Managed_child::Error err) {
-				new_exit_value = err.exit_value;
-				return State::INVALID;
-			});
-
-		if (new_state != State::GENERATE) {
-			_generate.destruct();
-			if (new_state != State::INVALID)
-				_last_generate_duration = _import_step_start.diff(current_secs);
-		}
-
-		break;
-	}
-	case State::SLEEP:
-	{
-		new_state = _sleep_timeout_triggered ? State::INIT
-		                                     : State::SLEEP;
-		_sleep_timeout_triggered = false;
-		break;
-	}
-	} /* switch */
-
-	/* the step is still being processed without apparent problems  */
-	if (_state == new_state && !reconfigure_init && !timeout)
-		return;
-
-	/* apply quota update */
-	if (reconfigure_init) {
-		Managed_init::generate_config([&] (Generator &g) {
-			_update_init_config(g); });
-		return;
-	}
-
-	/*
-	 * Start next processing step or restart the current one in
-	 * case the step-timeout triggered.
-	 */
-
-	if (!timeout || _step_timeout.scheduled())
-		_step_timeout.discard();
-
-	_import_step_start = current_secs;
-
-	switch (new_state) {
-	case State::FETCH:
-	{
-		if (timeout) _fetch->trigger_restart();
-		else         _fetch.construct(Managed_init::child_states, _config.fetchurl);
-		_step_timeout_secs = _calculate_timeout(_last_fetch_duration,
-		                                        /*
-		                                         * Failed downloads take up to 10s, so make
-		                                         * room for the odd ones out to fail.
-		                                         */
-		                                        Seconds{.value = 60u});
-		break;
-	}
-	case State::WIPE:
-	{
-		if (timeout) _wipe->trigger_restart();
-		else         _wipe.construct(Managed_init::child_states, _config.wipe);
-		_step_timeout_secs = _calculate_timeout(_last_wipe_duration);
-		break;
-	}
-	case State::EXTRACT:
-	{
-		if (timeout) _extract->trigger_restart();
-		else         _extract.construct(Managed_init::child_states, _config.extract);
-		_step_timeout_secs = _calculate_timeout(_last_extract_duration);
-		break;
-	}
-	case State::GENERATE:
-	{
-		if (timeout) _generate->trigger_restart();
-		else         _generate.construct(Managed_init::child_states, _config.generate);
-		_step_timeout_secs = _calculate_timeout(_last_generate_duration);
-		break;
-	}
-	case State::SLEEP:
-	{
-		Microseconds const to_us =
-			Microseconds { Microseconds(60'000'000ul).value * _config.sleep_duration };
-		_sleep_timeout.schedule(to_us);
-		_step_timeout_secs = { 0 };
-
-		++_imports;
-		Seconds const dur { .value = _config.sleep_duration * 60 };
-
-		_import_duration = _import_start.diff(current_secs);
-
-		_last_update = Utils::from_rtc(from_seconds(current_secs));
-		_next_update = Utils::from_rtc(from_seconds({ current_secs.value + dur.value }));
-		break;
-	}
-	default:
-		/* INIT and INVALID are of no concern at this point */
-		break;
-	} /* switch */
-
-	if (_step_timeout_secs.value) {
-		Microseconds const to_us =
-			Microseconds { Microseconds(1'000'000ul).value * _step_timeout_secs.value };
-		_step_timeout.schedule(to_us);
-	}
-
-	// TODO evaluate new_exit_value to handle different invalid states
-
-	_state = new_state;
-	Managed_init::generate_config([&] (Generator &g) {
-		_update_init_config(g); });
-}
-
-
-void Genodians::Import::_update_init_config(Generator &g)
-{
-	g.attribute("verbose", "no");
-
-	g.node("report", [&] {
-		g.attribute("init_ram",   "yes");
-		g.attribute("init_caps",  "yes");
-		g.attribute("child_ram",  "yes");
-		g.attribute("child_caps", "yes");
-		g.attribute("delay_ms",   5000);
-		g.attribute("buffer",     "64K");
-	});
-
-	g.node("parent-provides", [&] {
-		gen_parent_service<Rom_session>(g);
-		gen_parent_service<Cpu_session>(g);
-		gen_parent_service<Pd_session>(g);
-		gen_parent_service<Rm_session>(g);
-		gen_parent_service<Log_session>(g);
-		gen_parent_service<Timer::Session>(g);
-		gen_parent_service<Rtc::Session>(g);
-		gen_parent_service<Nic::Session>(g);
-		gen_parent_service<File_system::Session>(g);
-	});
-
-	gen_heartbeat_node(g, _config.heartbeat_ms);
-
-	gen_default_route_parent(g);
-
-	if (_fetch.constructed())    _fetch->   generate(g);
-	if (_wipe.constructed())     _wipe->    generate(g);
-	if (_extract.constructed())  _extract-> generate(g);
-	if (_generate.constructed()) _generate->generate(g);
-}
-
-
-struct Genodians::Lighttpd : Genodians::Managed_init
-{
-	Env &_env;
-
-	Rtc::Connection &_rtc;
-
-	void _update_init_config(Generator &);
-
-	Config::Lighttpd const &_config;
-
-	Child_state _child_state;
-
-	Date     _last_restart { };
-	unsigned _restarts = 0;
-
-	void _restart()
-	{
-		_restarts++;
-		_last_restart = from_rtc(_rtc.current_time());
-
-		Managed_init::generate_config([&] (Generator &g) {
-			_update_init_config(g); });
-	}
-
-	Lighttpd(Env                    &env,
-	         Allocator              &alloc,
-	         Notify_interface       &notify,
-	         Rtc::Connection        &rtc,
-	         Config::Lighttpd const &config)
-	:
-		Managed_init  { env, alloc, notify,
-		                "lighttpd.state", "lighttpd.config" },
-		_env          { env },
-		_rtc          { rtc },
-		_config       { config },
-		_child_state  { Managed_init::child_states, "lighttpd",
-		                Priority { 0 }, _config.lighttpd.ram,
-		                                _config.lighttpd.caps }
-	{
-		/* initial init configuration */
-		Managed_init::generate_config([&] (Generator &g) {
-			_update_init_config(g); });
-	}
-
-	void trigger_restart()
-	{
-		_child_state.trigger_restart();
-		_restart();
-	}
-
-	/****************************
-	 ** Managed_init interface **
-	 ****************************/
-
-	void generate_report(Xml_generator &xml)      const override;
-	void state_update   (Node const &, bool )     override;
-};
-
-
-void Genodians::Lighttpd::generate_report(Xml_generator &xml) const
-{
-	Html::gen_section_div(xml, "Lighttpd", [&] (Xml_generator &xml) {
-		Html::gen_table_body(xml, [&] (Xml_generator &xml) {
-			Html::gen_table_key_value_row(xml, Html::String("Total restarts"),
-			                                   Html::String(_restarts));
-			if (_restarts == 0)
-				return;
-
-			Html::gen_table_key_value_row(xml, Html::String("Last restart"),
-			                                   _last_restart);
-		});
-		Managed_init::with_cached_state_report([&] (Node const &node) {
-			xml.node("h4", [&] { xml.append("init-state-report"); });
-			xml.node("pre", [&] {
-				xml.attribute("lang", "xml");
-				xml.append_content(node); });
-		}, [&] { });
-	});
-}
-
-
-void Genodians::Lighttpd::state_update(Node const &state_node,
-                                       bool        reconfigure_init)
-{
-	Child_exit_state const exit_state(state_node, "lighttpd");
-
-	reconfigure_init |= exit_state.exited || !exit_state.responsive;
-
-	if (!reconfigure_init)
-		return;
-
-	_restart();
-}
-
-
-void Genodians::Lighttpd::_update_init_config(Generator &g)
-{
-	g.attribute("verbose", "no");
-
-	g.node("report", [&] {
-		g.attribute("init_ram",   "yes");
-		g.attribute("init_caps",  "yes");
-		g.attribute("child_ram",  "yes");
-		g.attribute("child_caps", "yes");
-		g.attribute("delay_ms",   5000);
-		g.attribute("buffer",     "64K");
-	});
-
-	g.node("parent-provides", [&] {
-		gen_parent_service<Rom_session>(g);
-		gen_parent_service<Cpu_session>(g);
-		gen_parent_service<Pd_session>(g);
-		gen_parent_service<Rm_session>(g);
-		gen_parent_service<Log_session>(g);
-		gen_parent_service<Timer::Session>(g);
-		gen_parent_service<Rtc::Session>(g);
-		gen_parent_service<Nic::Session>(g);
-		gen_parent_service<File_system::Session>(g);
-	});
-
-	gen_heartbeat_node(g, _config.heartbeat_ms);
-
-	g.node("start", [&] {
-		_child_state.gen_start_node_content(g);
-
-		g.node("heartbeat", [&] { });
-
-		g.node("config", [&] {
-			g.attribute("ld_verbose", "yes");
-
-			gen_arg(g, "lighttpd");
-			gen_arg(g, "-f");
-			gen_arg(g, "/etc/lighttpd/lighttpd.conf");
-			gen_arg(g, "-D");
-
-			g.node("vfs", [&] {
-
-				gen_named_dir(g, "dev", [&] (Generator &g) {
-					g.node("log",  [&] { });
-					g.node("null", [&] { });
-					g.node("rtc",  [&] { });
-					g.node("jitterentropy", [&] { g.attribute("name", "random"); }); });
-
-				gen_named_dir(g, "socket", [&] (Generator &g) {
-					g.node("lxip", [&] { g.attribute("dhcp", "yes"); }); });
-
-				gen_named_dir(g, "etc", [&] (Generator &g) {
-					gen_named_dir(g, "lighttpd", [&] (Generator &g) {
-						gen_rom(g, "lighttpd.conf");
-						gen_rom(g, "upload-user.conf");
-						g.node("fs", [&] { g.attribute("label", "cert"); }); }); });
-
-				gen_named_dir(g, "website", [&] (Generator &g) {
-					gen_named_dir(g, ".well-known", [&] (Generator &g) {
-						gen_symlink(g, "acme-challenge", "/upload/acme-challenge"); });
-					gen_symlink(g, "upload", "/upload");
-					g.node("fs", [&] { g.attribute("label", "website"); }); });
-
-				gen_named_dir(g, "upload", [&] (Generator &g) {
-					gen_symlink(g, "cert", "/etc/lighttpd/public");
-					gen_named_dir(g, "acme-challenge", [] (Generator &g) {
-						g.node("ram"); }); });
-
-			});
-
-			g.node("libc", [&] {
-				g.attribute("stdin",  "/dev/null");
-				g.attribute("stdout", "/dev/log");
-				g.attribute("stderr", "/dev/log");
-				g.attribute("rtc",    "/dev/rtc");
-				g.attribute("socket", "/socket"); }); });
-
-		g.node("route", [&] {
-			gen_service_node<File_system::Session>(g, [&] {
-				g.attribute("label", "cert");
-				g.node("parent", [&] {
-					g.attribute("label", "cert"); }); });
-			gen_service_node<File_system::Session>(g, [&] {
-				g.attribute("label", "website");
-				g.node("parent", [&] {
-					g.attribute("label", "website"); }); });
-			gen_service_node<Nic::Session>(g, [&] {
-				g.node("parent", [&] { }); });
-			gen_parent_route<Cpu_session>   (g);
-			gen_parent_route<Log_session>   (g);
-			gen_parent_route<Pd_session>    (g);
-			gen_parent_route<Rom_session>   (g);
-			gen_parent_route<Rtc::Session>  (g);
-			gen_parent_route<Timer::Session>(g);
-		});
-	});
-}
+namespace Genodians { struct Main; }
 
 
 struct Genodians::Main
@@ -1211,6 +50,32 @@ struct Genodians::Main
 	Lighttpd _lighttpd;
 	Import   _import;
 
+	unsigned _config_updates = 0;
+
+	Signal_handler<Main> _config_sigh {
+		_env.ep(), *this, &Main::_handle_config };
+
+	/*
+	 * Apply configuration updates without restarting the sub-systems
+	 *
+	 * The sub-systems refer to the parts of '_config' and compare the
+	 * new values with the former ones. The 'status_buffer_size' is only
+	 * evaluated at startup.
+	 */
+	void _handle_config()
+	{
+		Config const old = _config;
+
+		_config = _update_from_config_rom();
+		_config_updates++;
+
+		_lighttpd.apply_config(old.lighttpd_config);
+		_import.  apply_config(old.import_config);
+
+		/* reschedules the periodic status update */
+		_generate_status();
+	}
+
 	Timer::One_shot_timeout<Main> _fullchain_update_timeout {
 		_timer, *this, &Main::_handle_fullchain_update_timeout };
 
@@ -1245,8 +110,24 @@ struct Genodians::Main
 		_fullchain_update_timeout.schedule(schedule_restart);
 	}
 
+	struct Signal_notifier : Notify_interface
+	{
+		Signal_handler<Main> &_handler;
+
+		Signal_notifier(Signal_handler<Main> &handler)
+		: _handler { handler } { }
+
+		void notify() const override {
+			_handler.local_submit(); }
+	};
+
+	/*
+	 * The initial buffer size avoids growing the buffer step by step
+	 * on the first reports.
+	 */
 	Expanding_reporter _status_reporter {
-		_env, "html", "status.html" };
+		_env, "html", "status.html",
+		Expanding_reporter::Initial_buffer_size { _config.status_buffer_size } };
 
 	Signal_handler<Main> _status_sigh {
 		_env.ep(), *this, &Main::_handle_status };
@@ -1255,19 +136,45 @@ struct Genodians::Main
 		_timer, *this, &Main::_handle_status_timeout };
 
 	void _handle_status_timeout(Duration) {
-		_handle_status(); }
+		_generate_status(); }
+
+	/*
+	 * The metrics are not XML and therefore reported verbatim, the
+	 * buffer grows with the number of series
+	 */
+	Text_reporter _metrics_reporter { _env, "metrics", "metrics", 16u << 10 };
+
+	/*
+	 * State changes arriving within 'status_min_interval_ms' after the
+	 * last update are coalesced into one deferred update.
+	 */
+	Timer::One_shot_timeout<Main> _status_deferred_timeout {
+		_timer, *this, &Main::_handle_status_deferred_timeout };
+
+	void _handle_status_deferred_timeout(Duration) {
+		_generate_status(); }
+
+	uint64_t _last_status_update_us { 0 };
 
 	struct State_rom_handler
 	{
 		Attached_rom_dataspace            _rom;
 		Signal_handler<State_rom_handler> _sigh;
 
-		void _handle() { _rom.update(); }
+		Notify_interface &_update_notifier;
+
+		void _handle()
+		{
+			_rom.update();
+			_update_notifier.notify();
+		}
 
-		State_rom_handler(Env &env, char const *rom_name)
+		State_rom_handler(Env &env, char const *rom_name,
+		                  Notify_interface &update_notifier)
 		:
-			_rom  { env, rom_name },
-			_sigh { env.ep(), *this, &State_rom_handler::_handle }
+			_rom             { env, rom_name },
+			_sigh            { env.ep(), *this, &State_rom_handler::_handle },
+			_update_notifier { update_notifier }
 		{
 			_rom.sigh(_sigh);
 			_handle();
@@ -1277,8 +184,67 @@ struct Genodians::Main
 			if (_rom.valid()) fn(_rom.node()); }
 	};
 
+	Traffic_rates _traffic_rates { };
+
+	Signal_handler<Main> _nic_router_state_sigh {
+		_env.ep(), *this, &Main::_handle_nic_router_state };
+
+	Signal_notifier _nic_router_state_notifier { _nic_router_state_sigh };
+
 	State_rom_handler _nic_router_state_rom;
 
+	void _handle_nic_router_state()
+	{
+		uint64_t const now_ms = _timer.curr_time().trunc_to_plain_ms().value;
+
+		_nic_router_state_rom.with_node([&] (Node const &node) {
+			_traffic_rates.update(node, now_ms); });
+	}
+
+	void _generate_traffic_rates_report(Xml_generator &xml)
+	{
+		uint64_t const now_ms = _timer.curr_time().trunc_to_plain_ms().value;
+
+		auto td_right = [&] (Xml_generator &xml, Html::String const &value) {
+			xml.node("td", [&] {
+				xml.attribute("style", "text-align:right");
+				xml.append_sanitized(value.string()); });
+		};
+
+		xml.node("table", [&] {
+			xml.node("thead", [&] {
+				xml.node("tr", [&] {
+					static char const * const titles[] = {
+						"Rate", "Rx", "Rx peak 1m", "Rx peak 15m", "Rx peak 24h",
+						        "Tx", "Tx peak 1m", "Tx peak 15m", "Tx peak 24h" };
+
+					for (char const *title : titles)
+						xml.node("td", [&] {
+							xml.attribute("style", "text-align:center");
+							xml.append(title); }); }); });
+
+			xml.node("tbody", [&] {
+				_traffic_rates.for_each_domain([&] (Traffic_rates::Domain const &domain) {
+
+					Traffic_rates::Rate const peak_1m  = domain.peak(now_ms,  1*60'000);
+					Traffic_rates::Rate const peak_15m = domain.peak(now_ms, 15*60'000);
+					Traffic_rates::Rate const peak_24h = domain.peak_24h();
+
+					xml.node("tr", [&] {
+						xml.node("td", [&] {
+							xml.append_sanitized(domain.name.string()); });
+						td_right(xml, Html::rate_string(domain.current.rx));
+						td_right(xml, Html::rate_string(peak_1m.rx));
+						td_right(xml, Html::rate_string(peak_15m.rx));
+						td_right(xml, Html::rate_string(peak_24h.rx));
+						td_right(xml, Html::rate_string(domain.current.tx));
+						td_right(xml, Html::rate_string(peak_1m.tx));
+						td_right(xml, Html::rate_string(peak_15m.tx));
+						td_right(xml, Html::rate_string(peak_24h.tx));
+					}); }); });
+		});
+	}
+
 	void _generate_nic_router_report(Xml_generator &xml, Node const &node)
 	{
 		auto td_centered = [&] (Xml_generator &xml, auto value) {
@@ -1315,6 +281,35 @@ struct Genodians::Main
 	Utils::Seconds _uptime { 0 };
 	Date           _last_status_update { };
 
+	size_t _heap_peak = 0;
+
+	void _sample_heap_usage() {
+		_heap_peak = max(_heap_peak, _heap.consumed()); }
+
+	void _generate_manager_report(Xml_generator &xml)
+	{
+		auto kib = [] (size_t bytes) { return Html::String(bytes / 1024, " KiB"); };
+
+		Html::gen_section_div(xml, "Manager", [&] (Xml_generator &xml) {
+			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+				Html::gen_table_key_value_row(xml, Html::String("Heap used"),
+				                                   kib(_heap.consumed()));
+				Html::gen_table_key_value_row(xml, Html::String("Heap peak"),
+				                                   kib(_heap_peak));
+				Html::gen_table_key_value_row(xml, Html::String("RAM used"),
+				                                   kib(_env.pd().used_ram().value));
+				Html::gen_table_key_value_row(xml, Html::String("RAM avail"),
+				                                   kib(_env.pd().avail_ram().value));
+				Html::gen_table_key_value_row(xml, Html::String("Caps used"),
+				                                   Html::String(_env.pd().used_caps().value));
+				Html::gen_table_key_value_row(xml, Html::String("Caps avail"),
+				                                   Html::String(_env.pd().avail_caps().value));
+				Html::gen_table_key_value_row(xml, Html::String("Config updates"),
+				                                   Html::String(_config_updates));
+			});
+		});
+	}
+
 	void _generate_report(Xml_generator &xml)
 	{
 		Html::gen_section_div(xml, "Overview", [&] (Xml_generator &xml) {
@@ -1328,16 +323,437 @@ struct Genodians::Main
 				_nic_router_state_rom.with_node([&] (Node const &node) {
 					_generate_nic_router_report(xml, node);
 				});
+
+				_generate_traffic_rates_report(xml);
+			});
+		});
+	}
+
+	void _generate_metrics(Metrics &metrics)
+	{
+		metrics.family("genodians_uptime_seconds", "gauge",
+		               "Time since the start of the manager");
+		metrics.sample("genodians_uptime_seconds", _uptime.value);
+
+		metrics.family("genodians_manager_heap_bytes", "gauge",
+		               "Heap consumption of the manager");
+		metrics.sample("genodians_manager_heap_bytes", _heap.consumed());
+
+		metrics.family("genodians_manager_heap_peak_bytes", "gauge",
+		               "Peak heap consumption of the manager");
+		metrics.sample("genodians_manager_heap_peak_bytes", _heap_peak);
+
+		_nic_router_state_rom.with_node([&] (Node const &node) {
+
+			auto gen_bytes = [&] (char const *metric, char const *attr) {
+				node.for_each_sub_node("domain", [&] (Node const &domain) {
+					metrics.sample(metric, "domain",
+					               domain.attribute_value("name", Html::String()),
+					               domain.attribute_value(attr, 0ull)); }); };
+
+			metrics.family("genodians_nic_router_rx_bytes_total", "counter",
+			               "Bytes received per NIC-router domain");
+			gen_bytes("genodians_nic_router_rx_bytes_total", "rx_bytes");
+
+			metrics.family("genodians_nic_router_tx_bytes_total", "counter",
+			               "Bytes transmitted per NIC-router domain");
+			gen_bytes("genodians_nic_router_tx_bytes_total", "tx_bytes");
+		});
+
+		uint64_t const now_ms = _timer.curr_time().trunc_to_plain_ms().value;
+
+		auto gen_rates = [&] (char const *metric, auto const &rate_fn) {
+			_traffic_rates.for_each_domain([&] (Traffic_rates::Domain const &domain) {
+				Traffic_rates::Rate const peak_1m  = domain.peak(now_ms,  1*60'000);
+				Traffic_rates::Rate const peak_15m = domain.peak(now_ms, 15*60'000);
+				Traffic_rates::Rate const peak_24h = domain.peak_24h();
+
+				metrics.sample(metric, "domain", domain.name, "window", "now",
+				               rate_fn(domain.current));
+				metrics.sample(metric, "domain", domain.name, "window", "1m",
+				               rate_fn(peak_1m));
+				metrics.sample(metric, "domain", domain.name, "window", "15m",
+				               rate_fn(peak_15m));
+				metrics.sample(metric, "domain", domain.name, "window", "24h",
+				               rate_fn(peak_24h));
+			});
+		};
+
+		metrics.family("genodians_nic_router_rx_bytes_per_second", "gauge",
+		               "Current and peak receive rate per NIC-router domain");
+		gen_rates("genodians_nic_router_rx_bytes_per_second",
+		          [] (Traffic_rates::Rate const &rate) { return rate.rx; });
+
+		metrics.family("genodians_nic_router_tx_bytes_per_second", "gauge",
+		               "Current and peak transmit rate per NIC-router domain");
+		gen_rates("genodians_nic_router_tx_bytes_per_second",
+		          [] (Traffic_rates::Rate const &rate) { return rate.tx; });
+
+		metrics.family("genodians_http_requests_total", "counter",
+		               "Requests served by lighttpd per path class");
+		_access_log.for_each_class([&] (char const *name, Access_log::Class_stats const &stats) {
+			metrics.sample("genodians_http_requests_total", "class", name, stats.requests); });
+
+		metrics.family("genodians_http_response_bytes_total", "counter",
+		               "Bytes sent by lighttpd per path class");
+		_access_log.for_each_class([&] (char const *name, Access_log::Class_stats const &stats) {
+			metrics.sample("genodians_http_response_bytes_total", "class", name, stats.bytes); });
+
+		metrics.family("genodians_http_responses_total", "counter",
+		               "Responses of lighttpd per status code, 0 stands for others");
+		_access_log.for_each_status([&] (Access_log::Status_count const &status) {
+			metrics.sample("genodians_http_responses_total", "code", status.code,
+			               status.count); });
+
+		metrics.family("genodians_http_request_duration_seconds", "histogram",
+		               "Duration of the requests served by lighttpd");
+		metrics.duration_histogram("genodians_http_request_duration_seconds", "server", "lighttpd",
+		                           _access_log.durations());
+
+		metrics.family("genodians_http_requests_per_minute", "gauge",
+		               "Requests of the last complete minute and peak of the last hour");
+		metrics.sample("genodians_http_requests_per_minute", "window", "1m",
+		               _access_log.last_minute(now_ms));
+		metrics.sample("genodians_http_requests_per_minute", "window", "1h",
+		               _access_log.peak_minute(now_ms));
+
+		metrics.family("genodians_http_top_path_requests", "gauge",
+		               "Estimated requests of the most requested paths");
+		_access_log.for_each_top_path(10, [&] (auto const &entry) {
+			metrics.sample("genodians_http_top_path_requests", "path", entry.key,
+			               entry.count); });
+
+		metrics.family("genodians_probe_latency_seconds", "histogram",
+		               "Latency of the successful probe requests");
+		_latency_probe.for_each_target([&] (Latency_probe::Target const &target) {
+			metrics.duration_histogram("genodians_probe_latency_seconds", "path",
+			                           target.path.string(), target.latencies); });
+
+		metrics.family("genodians_probe_failures_total", "counter",
+		               "Number of failed probe requests");
+		_latency_probe.for_each_target([&] (Latency_probe::Target const &target) {
+			metrics.sample("genodians_probe_failures_total", "path", target.path,
+			               target.failures); });
+
+		metrics.family("genodians_probe_latency_p99_seconds", "gauge",
+		               "P99 latency of the recent probe requests");
+		metrics.sample("genodians_probe_latency_p99_seconds",
+		               Fractional_seconds { _latency_probe.p99_ms() });
+
+		_generate_storage_usage_metrics(metrics);
+
+		_lighttpd.generate_metrics(metrics);
+		_import.  generate_metrics(metrics);
+	}
+
+	void _report_metrics()
+	{
+		_metrics_reporter.generate([&] (Output &out) {
+			Metrics metrics { out };
+			_generate_metrics(metrics); });
+	}
+
+	void _generate_probe_report(Xml_generator &xml)
+	{
+		if (!_latency_probe.rounds())
+			return;
+
+		auto td_right = [&] (Xml_generator &xml, Html::String const &value) {
+			xml.node("td", [&] {
+				xml.attribute("style", "text-align:right");
+				xml.append_sanitized(value.string()); });
+		};
+
+		Html::gen_section_div(xml, "Probe", [&] (Xml_generator &xml) {
+			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+				Html::gen_table_key_value_row(xml, Html::String("Rounds"),
+				                                   Html::String(_latency_probe.rounds()));
+				Html::gen_table_key_value_row(xml, Html::String("Latency p99"),
+				                                   Html::String(_latency_probe.p99_ms(), " ms"));
+				Html::gen_table_key_value_row(xml, Html::String("Degraded rounds"),
+				                                   Html::String(_latency_probe.degraded_rounds()));
+				Html::gen_table_key_value_row(xml, Html::String("Failed rounds"),
+				                                   Html::String(_latency_probe.failed_rounds()));
+			});
+
+			xml.node("table", [&] {
+				xml.node("thead", [&] {
+					xml.node("tr", [&] {
+						static char const * const titles[] = {
+							"URL", "Result", "Status", "Latency", "Failures" };
+
+						for (char const *title : titles)
+							xml.node("td", [&] {
+								xml.attribute("style", "text-align:center");
+								xml.append(title); }); }); });
+
+				xml.node("tbody", [&] {
+					_latency_probe.for_each_target([&] (Latency_probe::Target const &target) {
+						xml.node("tr", [&] {
+							xml.node("td", [&] {
+								xml.append_sanitized(target.path.string()); });
+							td_right(xml, Html::String(target.error.valid() ? target.error : target.result));
+							td_right(xml, Html::String(target.status));
+							td_right(xml, Html::String(target.latency_ms, " ms"));
+							td_right(xml, Html::String(target.failures));
+						}); }); });
+			});
+		});
+	}
+
+	void _generate_access_log_report(Xml_generator &xml)
+	{
+		if (!_access_log.requests())
+			return;
+
+		uint64_t const now_ms = _timer.curr_time().trunc_to_plain_ms().value;
+
+		auto td_right = [&] (Xml_generator &xml, Html::String const &value) {
+			xml.node("td", [&] {
+				xml.attribute("style", "text-align:right");
+				xml.append_sanitized(value.string()); });
+		};
+
+		auto gen_thead = [&] (Xml_generator &xml, auto const &titles) {
+			xml.node("thead", [&] {
+				xml.node("tr", [&] {
+					for (char const *title : titles)
+						xml.node("td", [&] {
+							xml.attribute("style", "text-align:center");
+							xml.append(title); }); }); });
+		};
+
+		Html::gen_section_div(xml, "Access", [&] (Xml_generator &xml) {
+			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+				Html::gen_table_key_value_row(xml, Html::String("Requests"),
+				                                   Html::String(_access_log.requests()));
+				Html::gen_table_key_value_row(xml, Html::String("Last minute"),
+				                                   Html::String(_access_log.last_minute(now_ms), " requests"));
+				Html::gen_table_key_value_row(xml, Html::String("Peak minute 1h"),
+				                                   Html::String(_access_log.peak_minute(now_ms), " requests"));
+				if (_access_log.malformed())
+					Html::gen_table_key_value_row(xml, Html::String("Malformed lines"),
+					                                   Html::String(_access_log.malformed()));
+			});
+
+			xml.node("table", [&] {
+				static char const * const titles[] = { "Class", "Requests", "Bytes" };
+				gen_thead(xml, titles);
+				xml.node("tbody", [&] {
+					_access_log.for_each_class([&] (char const *name,
+					                                Access_log::Class_stats const &stats) {
+						if (!stats.requests)
+							return;
+						xml.node("tr", [&] {
+							xml.node("td", [&] { xml.append(name); });
+							td_right(xml, Html::String(stats.requests));
+							td_right(xml, Html::String(Number_of_bytes(stats.bytes)));
+						}); }); });
+			});
+
+			xml.node("table", [&] {
+				static char const * const titles[] = { "Status", "Responses" };
+				gen_thead(xml, titles);
+				xml.node("tbody", [&] {
+					_access_log.for_each_status([&] (Access_log::Status_count const &status) {
+						xml.node("tr", [&] {
+							td_right(xml, status.code ? Html::String(status.code)
+							                          : Html::String("other"));
+							td_right(xml, Html::String(status.count));
+						}); }); });
+			});
+
+			xml.node("p", [&] { xml.append("Most requested"); });
+			xml.node("table", [&] {
+				static char const * const titles[] = { "Path", "Requests" };
+				gen_thead(xml, titles);
+				xml.node("tbody", [&] {
+					_access_log.for_each_top_path(10, [&] (auto const &entry) {
+						xml.node("tr", [&] {
+							xml.node("td", [&] {
+								xml.append_sanitized(entry.key.string()); });
+							td_right(xml, Html::String(entry.error ? "≤ " : "", entry.count));
+						}); }); });
+			});
+		});
+	}
+
+	void _generate_build_timing_report(Xml_generator &xml)
+	{
+		using Name = String<128>;
+
+		auto td_right = [&] (Xml_generator &xml, Html::String const &value) {
+			xml.node("td", [&] {
+				xml.attribute("style", "text-align:right");
+				xml.append_sanitized(value.string()); });
+		};
+
+		auto gen_thead = [&] (Xml_generator &xml, auto const &titles) {
+			xml.node("thead", [&] {
+				xml.node("tr", [&] {
+					for (char const *title : titles)
+						xml.node("td", [&] {
+							xml.attribute("style", "text-align:center");
+							xml.append(title); }); }); });
+		};
+
+		_build_timing_rom.with_node([&] (Node const &node) {
+
+			if (!node.has_type("build_timing"))
+				return;
+
+			Html::gen_section_div(xml, "Generate", [&] (Xml_generator &xml) {
+				Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+					Html::gen_table_key_value_row(xml, Html::String("Targets"),
+						Html::String(node.attribute_value("targets", 0u)));
+					Html::gen_table_key_value_row(xml, Html::String("Total time"),
+						Html::String(Duration_ms { node.attribute_value("total_ms", 0ull) }));
+				});
+
+				xml.node("p", [&] { xml.append("Time per class"); });
+				xml.node("table", [&] {
+					static char const * const titles[] = { "Class", "Targets", "Time" };
+					gen_thead(xml, titles);
+					xml.node("tbody", [&] {
+						node.for_each_sub_node("class", [&] (Node const &class_node) {
+							xml.node("tr", [&] {
+								xml.node("td", [&] {
+									xml.append_sanitized(class_node.attribute_value("name", Name()).string()); });
+								td_right(xml, Html::String(class_node.attribute_value("targets", 0u)));
+								td_right(xml, Html::String(Duration_ms { class_node.attribute_value("ms", 0ull) }));
+							}); }); });
+				});
+
+				xml.node("p", [&] { xml.append("Slowest targets"); });
+				xml.node("table", [&] {
+					static char const * const titles[] = { "Target", "Class", "Time" };
+					gen_thead(xml, titles);
+					xml.node("tbody", [&] {
+						node.for_each_sub_node("target", [&] (Node const &target) {
+							xml.node("tr", [&] {
+								xml.node("td", [&] {
+									xml.append_sanitized(target.attribute_value("name", Name()).string()); });
+								xml.node("td", [&] {
+									xml.append_sanitized(target.attribute_value("class", Name()).string()); });
+								td_right(xml, Html::String(Duration_ms { target.attribute_value("ms", 0ull) }));
+							}); }); });
+				});
+			});
+		});
+	}
+
+	void _generate_storage_usage_report(Xml_generator &xml)
+	{
+		using Name = String<32>;
+
+		auto td_right = [&] (Xml_generator &xml, Html::String const &value) {
+			xml.node("td", [&] {
+				xml.attribute("style", "text-align:right");
+				xml.append_sanitized(value.string()); });
+		};
+
+		auto bytes = [&] (Node const &node, char const *attr) {
+			return Html::String(Number_of_bytes(node.attribute_value(attr, 0ull))); };
+
+		_storage_usage_rom.with_node([&] (Node const &node) {
+
+			if (!node.has_type("storage_usage"))
+				return;
+
+			Html::gen_section_div(xml, "Storage", [&] (Xml_generator &xml) {
+				xml.node("table", [&] {
+					xml.node("thead", [&] {
+						xml.node("tr", [&] {
+							static char const * const titles[] = {
+								"File system", "Files", "Links", "Size",
+								"Allocated", "Duplicate", "Compressed" };
+
+							for (char const *title : titles)
+								xml.node("td", [&] {
+									xml.attribute("style", "text-align:center");
+									xml.append(title); }); }); });
+
+					xml.node("tbody", [&] {
+						node.for_each_sub_node("fs", [&] (Node const &fs) {
+							xml.node("tr", [&] {
+								xml.node("td", [&] {
+									xml.append_sanitized(fs.attribute_value("name", Name()).string()); });
+								td_right(xml, Html::String(fs.attribute_value("files", 0u)));
+								td_right(xml, Html::String(fs.attribute_value("links", 0u)));
+								td_right(xml, bytes(fs, "bytes"));
+								td_right(xml, bytes(fs, "allocated"));
+								td_right(xml, bytes(fs, "duplicate"));
+								td_right(xml, bytes(fs, "compressed"));
+							}); }); });
+				});
 			});
 		});
 	}
 
+	void _generate_storage_usage_metrics(Metrics &metrics)
+	{
+		using Name = String<32>;
+
+		_storage_usage_rom.with_node([&] (Node const &node) {
+
+			if (!node.has_type("storage_usage"))
+				return;
+
+			auto gen = [&] (char const *metric, char const *attr) {
+				node.for_each_sub_node("fs", [&] (Node const &fs) {
+					metrics.sample(metric, "fs", fs.attribute_value("name", Name()),
+					               fs.attribute_value(attr, 0ull)); }); };
+
+			metrics.family("genodians_fs_files", "gauge",
+			               "Number of regular files per file system");
+			gen("genodians_fs_files", "files");
+
+			metrics.family("genodians_fs_bytes", "gauge",
+			               "Size of the regular files per file system");
+			gen("genodians_fs_bytes", "bytes");
+
+			metrics.family("genodians_fs_allocated_bytes", "gauge",
+			               "Estimated resident size of the files per file system");
+			gen("genodians_fs_allocated_bytes", "allocated");
+
+			metrics.family("genodians_fs_duplicate_bytes", "gauge",
+			               "Size of the files with the content of another file");
+			gen("genodians_fs_duplicate_bytes", "duplicate");
+		});
+	}
+
 	void _handle_status()
 	{
+		_sample_heap_usage();
+
+		if (_status_deferred_timeout.scheduled())
+			return;
+
+		uint64_t const now_us = _timer.curr_time().trunc_to_plain_us().value;
+		uint64_t const min_us = 1'000ull * _config.status_min_interval_ms;
+		uint64_t const elapsed_us = now_us - _last_status_update_us;
+
+		if (_last_status_update_us && elapsed_us < min_us) {
+			_status_deferred_timeout.schedule(Microseconds { min_us - elapsed_us });
+			return;
+		}
+
+		_generate_status();
+	}
+
+	void _generate_status()
+	{
+		if (_status_deferred_timeout.scheduled())
+			_status_deferred_timeout.discard();
+
+		_last_status_update_us = _timer.curr_time().trunc_to_plain_us().value;
+
 		_last_status_update = from_rtc(_rtc.current_time());
 
 		_uptime = { _timer.curr_time().trunc_to_plain_ms().value / 1'000u };
 
+		_sample_heap_usage();
+
 		_status_reporter.generate_xml([&] (Xml_generator &xml) {
 
 			xml.node("head", [&] {
@@ -1352,12 +768,20 @@ struct Genodians::Main
 				xml.attribute("style", "font-family:monospace");
 
 				_generate_report(xml);
+				_generate_manager_report(xml);
 
 				_lighttpd.generate_report(xml);
+				_generate_probe_report(xml);
+				_generate_access_log_report(xml);
 				_import.  generate_report(xml);
+
+				_generate_build_timing_report(xml);
+				_generate_storage_usage_report(xml);
 			});
 		});
 
+		_report_metrics();
+
 		/*
 		 * Make sure the status is updated once in a while in case
 		 * the init-state reports are triggered sparingly.
@@ -1367,65 +791,170 @@ struct Genodians::Main
 		_status_timeout.schedule(next_update);
 	}
 
-	struct Status_notifier : Notify_interface
+	Signal_notifier _status_notifier { _status_sigh };
+
+	/* summary of the per-target build times of the last generate step */
+	State_rom_handler _build_timing_rom;
+
+	/* space occupied by the content and website file systems */
+	State_rom_handler _storage_usage_rom;
+
+	Signal_handler<Main> _website_update_sigh {
+		_env.ep(), *this, &Main::_handle_website_update };
+
+	/*
+	 * Taking a new snapshot restarts lighttpd, which drops the open
+	 * connections. The restart is therefore deferred until no request
+	 * was logged for 'SNAPSHOT_IDLE_MS', which approximates lighttpd
+	 * having no request in flight, but for 'SNAPSHOT_MAX_DELAY_MS' at
+	 * most. Website updates arriving meanwhile are covered by the
+	 * pending snapshot.
+	 */
+	static constexpr uint64_t SNAPSHOT_IDLE_MS      =  2'000;
+	static constexpr uint64_t SNAPSHOT_MAX_DELAY_MS = 60'000;
+	static constexpr uint64_t SNAPSHOT_POLL_MS      =    500;
+
+	bool     _snapshot_pending      = false;
+	uint64_t _snapshot_requested_ms = 0;
+
+	Timer::One_shot_timeout<Main> _snapshot_timeout {
+		_timer, *this, &Main::_handle_snapshot_timeout };
+
+	void _handle_website_update()
 	{
-		Signal_handler<Main> &_handler;
+		if (!_config.lighttpd_config.snapshot || _snapshot_pending)
+			return;
 
-		Status_notifier(Signal_handler<Main> &handler)
-		: _handler { handler } { }
+		_snapshot_pending      = true;
+		_snapshot_requested_ms = _timer.curr_time().trunc_to_plain_ms().value;
+		_snapshot_timeout.schedule(Microseconds { SNAPSHOT_POLL_MS * 1000 });
+	}
 
-		void notify() const override {
-			_handler.local_submit(); }
-	};
+	void _handle_snapshot_timeout(Duration)
+	{
+		uint64_t const now_ms = _timer.curr_time().trunc_to_plain_ms().value;
+
+		bool const idle    = now_ms - _access_log.last_request_ms() >= SNAPSHOT_IDLE_MS;
+		bool const overdue = now_ms - _snapshot_requested_ms        >= SNAPSHOT_MAX_DELAY_MS;
+
+		if (!idle && !overdue) {
+			_snapshot_timeout.schedule(Microseconds { SNAPSHOT_POLL_MS * 1000 });
+			return;
+		}
+
+		_snapshot_pending = false;
+		_lighttpd.update_snapshot();
+
+		/* failed probes during the restart are not held against lighttpd */
+		_latency_probe.restart();
+		_status_notifier.notify();
+	}
+
+	Signal_notifier _website_update_notifier { _website_update_sigh };
+
+	/*
+	 * LOG service receiving the access log of lighttpd
+	 */
+
+	Access_log _access_log { };
+
+	struct Access_log_session : Rpc_object<Log_session, Access_log_session>
+	{
+		Access_log        &_access_log;
+		Timer::Connection &_timer;
+
+		/* a line may be split across several writes */
+		char   _line[256] { };
+		size_t _line_len = 0;
+
+		Access_log_session(Access_log &access_log, Timer::Connection &timer)
+		: _access_log { access_log }, _timer { timer } { }
+
+		void write(String const &string) override
+		{
+			if (!string.valid_string())
+				return;
+
+			uint64_t const now_ms = _timer.curr_time().trunc_to_plain_ms().value;
+
+			for (char const *s = string.string(); *s; s++) {
+				if (*s == '\r')
+					continue;
 
-	Status_notifier _status_notifier { _status_sigh };
+				if (*s != '\n') {
+					if (_line_len < sizeof(_line) - 1)
+						_line[_line_len++] = *s;
+					continue;
+				}
 
-	Rom_handler<Main> _fetch_lighttpd_handler;
+				_line[_line_len] = 0;
+				if (_line_len)
+					_access_log.apply(_line, now_ms);
+				_line_len = 0;
+			}
+		}
+	};
 
-	void _handle_fetch_lighttpd(Node const &node)
+	struct Access_log_root : Root_component<Access_log_session>
 	{
-		static constexpr unsigned MAX_CHECKS = 3;
-		static unsigned check_count = 0;
+		Access_log        &_access_log;
+		Timer::Connection &_timer;
+
+		Create_result _create_session(char const *) override {
+			return *new (md_alloc()) Access_log_session(_access_log, _timer); }
+
+		Access_log_root(Entrypoint &ep, Allocator &md_alloc,
+		                Access_log &access_log, Timer::Connection &timer)
+		:
+			Root_component<Access_log_session> { ep, md_alloc },
+			_access_log { access_log }, _timer { timer }
+		{ }
+	};
 
+	Sliced_heap _sliced_heap { _env.ram(), _env.rm() };
+
+	Access_log_root _access_log_root {
+		_env.ep(), _sliced_heap, _access_log, _timer };
+
+	Latency_probe _latency_probe { };
+
+	Rom_handler<Main> _probe_handler;
+
+	void _handle_probe(Node const &node)
+	{
 		/* inhibit check when we have not yet imported anything */
 		if (!_import._imports) {
 			log("Inhibit lighttpd check");
 			return;
 		}
 
-		auto check_progress = [&] (Node const &fetch_node) {
-			/* ignore transient reports */
-			if (!fetch_node.attribute_value("finished", false))
-				return;
-
-			using Result = String<16>;
-
-			Result const result = fetch_node.attribute_value("result", Result());
-			/* never happens */
-			if (!result.valid())
-				return;
+		using Verdict = Latency_probe::Verdict;
 
-			if (result == "failed")
-				++check_count;
-			else if (result == "success")
-				check_count = 0;
+		Verdict const verdict =
+			_latency_probe.update(node, _config.lighttpd_config.probe);
 
-			if (check_count) {
-				log("Lighttpd check already failed ", check_count, " times");
+		if (verdict == Verdict::HEALTHY) {
+			if (_latency_probe.failed_rounds()) {
+				log("Lighttpd check already failed ",
+				    _latency_probe.failed_rounds(), " times");
 
 				_nic_router_state_rom.with_node([&] (Node const &node) {
 					log(node);
 				});
 			}
+			return;
+		}
 
-			if (check_count >= MAX_CHECKS) {
-				/* XXX consider certificate update */
-				log("Restart lighttpd as the check failed repeatedly");
-				_lighttpd.trigger_restart();
-				check_count = 0;
-			}
-		};
-		node.with_optional_sub_node("fetch", check_progress);
+		/* XXX consider certificate update */
+		if (verdict == Verdict::FAILED)
+			log("Restart lighttpd as the check failed repeatedly");
+		else
+			log("Restart lighttpd as the p99 latency of ", _latency_probe.p99_ms(),
+			    " ms persisted for ", _latency_probe.degraded_rounds(), " rounds");
+
+		_lighttpd.trigger_restart();
+		_latency_probe.restart();
+		_status_notifier.notify();
 	}
 
 	Main(Env &env)
@@ -1434,18 +963,23 @@ struct Genodians::Main
 		_timer    { _env },
 		_rtc      { _env },
 		_config   { _update_from_config_rom() },
-		_lighttpd { _env, _heap, _status_notifier, _rtc,
+		_lighttpd { _env, _status_notifier, _rtc,
 		                         _config.lighttpd_config },
-		_import   { _env, _heap, _status_notifier, _timer, _rtc,
-		                         _config.import_config },
-		_nic_router_state_rom { _env, "nic_router.state" },
-		_fetch_lighttpd_handler { _env, "fetch_lighttpd.report", *this,
-		                          &Main::_handle_fetch_lighttpd }
+		_import   { _env, _status_notifier, _website_update_notifier,
+		                         _timer, _rtc, _config.import_config },
+		_nic_router_state_rom { _env, "nic_router.state",
+		                        _nic_router_state_notifier },
+		_build_timing_rom { _env, "build_timing.xml", _status_notifier },
+		_storage_usage_rom { _env, "storage_usage.xml", _status_notifier },
+		_probe_handler { _env, "probe.report", *this, &Main::_handle_probe }
 	{
 		_fullchain_rom.sigh(_fullchain_rom_sigh);
+		_config_rom.sigh(_config_sigh);
+
+		_env.parent().announce(_env.ep().manage(_access_log_root));
 
 		/* trigger initial status report */
-		_handle_status();
+		_generate_status();
 	}
 };
 
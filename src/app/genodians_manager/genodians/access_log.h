@@ -0,0 +1,327 @@
+/*
+ * \brief  Aggregation of the lighttpd access log
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__ACCESS_LOG_H_
+#define _GENODIANS__ACCESS_LOG_H_
+
+/* local includes */
+#include <genodians/types.h>
+
+namespace Genodians {
+
+	/*
+	 * Most frequent keys of a stream, tracked with the space-saving algorithm
+	 *
+	 * Only 'K' counters are kept. A key not yet tracked replaces the
+	 * least-counted one and inherits its count, which is recorded as
+	 * the possible over-estimation 'error' of the new key.
+	 */
+	template <typename KEY, unsigned K>
+	struct Top_k
+	{
+		struct Entry
+		{
+			KEY      key   { };
+			uint64_t count = 0;
+			uint64_t error = 0;
+		};
+
+		Entry    _entries[K] { };
+		unsigned _num_entries = 0;
+
+		void observe(KEY const &key)
+		{
+			Entry *least = nullptr;
+			for (unsigned i = 0; i < _num_entries; i++) {
+				if (_entries[i].key == key) {
+					_entries[i].count++;
+					return;
+				}
+				if (!least || _entries[i].count < least->count)
+					least = &_entries[i];
+			}
+
+			if (_num_entries < K) {
+				_entries[_num_entries++] = { key, 1, 0 };
+				return;
+			}
+
+			least->key   = key;
+			least->error = least->count;
+			least->count++;
+		}
+
+		/*
+		 * Call 'fn' for the 'n' most frequent keys, highest count first
+		 */
+		void for_each_top(unsigned n, auto const &fn) const
+		{
+			unsigned order[K];
+			for (unsigned i = 0; i < _num_entries; i++) {
+				unsigned j = i;
+				for (; j > 0 && _entries[order[j - 1]].count < _entries[i].count; j--)
+					order[j] = order[j - 1];
+				order[j] = i;
+			}
+
+			for (unsigned i = 0; i < min(n, _num_entries); i++)
+				fn(_entries[order[i]]);
+		}
+	};
+
+	/*
+	 * Aggregated lighttpd access log
+	 *
+	 * Each log line has the format "<status> <bytes> <microseconds> <path>"
+	 * as configured by 'accesslog.format' in 'lighttpd.conf'. The lines
+	 * are only aggregated, never stored, so the memory stays bounded.
+	 */
+	struct Access_log
+	{
+		enum class Path_class { PAGE, FEED, ASSET, STATUS, UPLOAD, OTHER };
+
+		static constexpr unsigned NUM_CLASSES = 6;
+
+		static char const *class_name(Path_class c)
+		{
+			switch (c) {
+			case Path_class::PAGE:   return "page";
+			case Path_class::FEED:   return "feed";
+			case Path_class::ASSET:  return "asset";
+			case Path_class::STATUS: return "status";
+			case Path_class::UPLOAD: return "upload";
+			case Path_class::OTHER:  return "other";
+			}
+			return "other";
+		}
+
+		using Path = String<96>;
+
+		static bool _starts_with(Path const &path, char const *prefix) {
+			return strcmp(path.string(), prefix, strlen(prefix)) == 0; }
+
+		static bool _ends_with(Path const &path, char const *suffix)
+		{
+			size_t const len = strlen(path.string()), suffix_len = strlen(suffix);
+			return len >= suffix_len
+			    && strcmp(path.string() + len - suffix_len, suffix) == 0;
+		}
+
+		static Path_class _classify(Path const &path)
+		{
+			if (_starts_with(path, "/genodians_manager/"))
+				return Path_class::STATUS;
+			if (_starts_with(path, "/upload") || _starts_with(path, "/.well-known/"))
+				return Path_class::UPLOAD;
+			if (_ends_with(path, "rss") || _ends_with(path, "RSS")
+			 || _ends_with(path, "rss.gz") || _ends_with(path, "RSS.gz"))
+				return Path_class::FEED;
+
+			static char const * const asset_suffixes[] = {
+				".css", ".css.gz", ".png", ".ico", ".jpg", ".svg", ".js" };
+
+			for (char const *suffix : asset_suffixes)
+				if (_ends_with(path, suffix))
+					return Path_class::ASSET;
+
+			if (path.length() > 1 && path.string()[0] == '/')
+				return Path_class::PAGE;
+			return Path_class::OTHER;
+		}
+
+		struct Class_stats
+		{
+			uint64_t requests = 0;
+			uint64_t bytes    = 0;
+		};
+
+		struct Status_count
+		{
+			unsigned code  = 0;
+			uint64_t count = 0;
+		};
+
+		static constexpr unsigned MAX_STATUS_CODES = 16;
+
+		/* bucket bounds of the request-duration histogram in milliseconds */
+		static constexpr uint64_t _duration_bounds[] = {
+			1, 5, 10, 25, 50, 100, 250, 500, 1'000, 5'000 };
+
+		using Duration_histogram = Histogram<sizeof(_duration_bounds)/sizeof(uint64_t)>;
+
+		static constexpr unsigned TOP_PATHS   = 64;
+		static constexpr unsigned NUM_MINUTES = 60;
+
+		static constexpr uint64_t MINUTE_MS = 60'000;
+
+		uint64_t           _requests  = 0;
+		uint64_t           _malformed = 0;
+		Class_stats        _classes[NUM_CLASSES] { };
+		Status_count       _status[MAX_STATUS_CODES] { };
+		unsigned           _num_status = 0;
+		Duration_histogram _durations { _duration_bounds };
+
+		Top_k<Path, TOP_PATHS> _top_paths { };
+
+		/* requests per minute of the last hour */
+		Ring_buffer<uint32_t, NUM_MINUTES> _minutes { };
+
+		uint64_t _minute          = 0;
+		uint32_t _minute_requests = 0;
+
+		uint64_t _last_request_ms = 0;
+
+		void _advance_minute(uint64_t now_ms)
+		{
+			uint64_t const now_minute = now_ms / MINUTE_MS;
+			if (now_minute == _minute)
+				return;
+
+			/* minutes without requests are idle */
+			if (_minute) {
+				_minutes.add(_minute_requests);
+				for (uint64_t m = _minute + 1; m < now_minute
+				                            && m <= _minute + NUM_MINUTES; m++)
+					_minutes.add(0);
+			}
+			_minute          = now_minute;
+			_minute_requests = 0;
+		}
+
+		void _count_status(unsigned code)
+		{
+			for (unsigned i = 0; i < _num_status; i++)
+				if (_status[i].code == code) {
+					_status[i].count++;
+					return;
+				}
+
+			if (_num_status < MAX_STATUS_CODES - 1) {
+				_status[_num_status++] = { code, 1 };
+				return;
+			}
+
+			/* codes beyond the capacity are accounted as code 0 in the last slot */
+			Status_count &other = _status[MAX_STATUS_CODES - 1];
+			other.code = 0;
+			other.count++;
+			_num_status = MAX_STATUS_CODES;
+		}
+
+		/*
+		 * Apply one log line
+		 */
+		void apply(char const *line, uint64_t now_ms)
+		{
+			using Token = String<16>;
+
+			auto next_token = [&] (auto &token) {
+				while (*line == ' ') line++;
+				char const *start = line;
+				while (*line && *line != ' ') line++;
+				token = { Cstring(start, size_t(line - start)) };
+			};
+
+			Token status_token { }, bytes_token { }, usecs_token { };
+			next_token(status_token);
+			next_token(bytes_token);
+			next_token(usecs_token);
+			while (*line == ' ') line++;
+
+			/*
+			 * The path ends at the line end. Overly long paths are truncated
+			 * and characters that would need escaping in the metrics are
+			 * replaced.
+			 */
+			char path_buf[Path::capacity()] { };
+			for (size_t i = 0; i < sizeof(path_buf) - 1 && line[i]; i++) {
+				char const c = line[i];
+				path_buf[i] = (c == '"' || c == '\\' || (unsigned char)c < ' ') ? '_' : c;
+			}
+			Path const path { Cstring(path_buf) };
+
+			unsigned status = 0;
+			uint64_t bytes = 0, usecs = 0;
+
+			if (!ascii_to(status_token.string(), status) || !path.valid()) {
+				_malformed++;
+				return;
+			}
+
+			/* lighttpd logs '-' if no body was sent */
+			ascii_to(bytes_token.string(), bytes);
+			ascii_to(usecs_token.string(), usecs);
+
+			_advance_minute(now_ms);
+			_minute_requests++;
+			_requests++;
+			_last_request_ms = now_ms;
+
+			Class_stats &stats = _classes[unsigned(_classify(path))];
+			stats.requests++;
+			stats.bytes += bytes;
+
+			_count_status(status);
+			_durations.observe(usecs / 1000);
+			_top_paths.observe(path);
+		}
+
+		/*
+		 * Requests of the last complete minute and peak of the last hour
+		 */
+		uint32_t last_minute(uint64_t now_ms)
+		{
+			_advance_minute(now_ms);
+			uint32_t result = 0;
+			_minutes.for_each_recent([&] (uint32_t const count) {
+				result = count;
+				return false; });
+			return result;
+		}
+
+		uint32_t peak_minute(uint64_t now_ms)
+		{
+			_advance_minute(now_ms);
+			uint32_t result = _minute_requests;
+			_minutes.for_each_recent([&] (uint32_t const count) {
+				result = max(result, count);
+				return true; });
+			return result;
+		}
+
+		uint64_t requests()  const { return _requests; }
+		uint64_t malformed() const { return _malformed; }
+
+		/* time of the last logged request, 0 if none was logged yet */
+		uint64_t last_request_ms() const { return _last_request_ms; }
+
+		Duration_histogram const &durations() const { return _durations; }
+
+		void for_each_class(auto const &fn) const
+		{
+			for (unsigned i = 0; i < NUM_CLASSES; i++)
+				fn(class_name(Path_class(i)), _classes[i]);
+		}
+
+		void for_each_status(auto const &fn) const
+		{
+			for (unsigned i = 0; i < _num_status; i++)
+				fn(_status[i]);
+		}
+
+		void for_each_top_path(unsigned n, auto const &fn) const {
+			_top_paths.for_each_top(n, fn); }
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__ACCESS_LOG_H_ */
@@ -0,0 +1,69 @@
+/*
+ * \brief  Progress of a child of a managed init
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__CHILD_PROGRESS_H_
+#define _GENODIANS__CHILD_PROGRESS_H_
+
+namespace Genodians {
+
+	/*
+	 * Progress of a child as seen in the state reports of its init
+	 *
+	 * The evaluation merely depends on the values of the report, not on
+	 * the report itself.
+	 */
+	struct Child_progress
+	{
+		enum class Verdict { PENDING, FINISHED, FAILED };
+
+		/* exit values of failures not reported by the child itself */
+		static constexpr int UNRESPONSIVE = -42;
+		static constexpr int UNSUPERVISED = -43;
+
+		Verdict verdict;
+		int     exit_value;   /* of a failed child */
+
+		/* same criterion as used by the sculpt manager */
+		static bool responsive(unsigned skipped_heartbeats) {
+			return skipped_heartbeats <= 2; }
+
+		static Child_progress listed(bool exited, int exit_code,
+		                             unsigned skipped_heartbeats)
+		{
+			if (!responsive(skipped_heartbeats))
+				return { Verdict::FAILED, UNRESPONSIVE };
+			if (!exited)
+				return { Verdict::PENDING, 0 };
+			if (exit_code != 0)
+				return { Verdict::FAILED, exit_code };
+
+			return { Verdict::FINISHED, 0 };
+		}
+
+		/*
+		 * Progress of a child missing in the report
+		 *
+		 * A child is missing until init started it. If the report listed
+		 * more children than were kept, it would never be seen finished.
+		 */
+		static Child_progress missing(bool children_dropped)
+		{
+			if (children_dropped)
+				return { Verdict::FAILED, UNSUPERVISED };
+
+			return { Verdict::PENDING, 0 };
+		}
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__CHILD_PROGRESS_H_ */
@@ -0,0 +1,79 @@
+/*
+ * \brief  Conversion between calendar dates and seconds since the epoch
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__CIVIL_TIME_H_
+#define _GENODIANS__CIVIL_TIME_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+
+namespace Utils {
+
+	using Genode::uint64_t;
+
+	/*
+	 * UTC date of the proleptic Gregorian calendar
+	 *
+	 * The conversions use the days-from-civil algorithm by Howard Hinnant,
+	 * which counts 400-year eras of 146097 days and does not need any
+	 * table or loop. Dates before 1970 are not supported.
+	 */
+	struct Civil_time
+	{
+		unsigned year, month, day;      /* month and day start at 1 */
+		unsigned hour, minute, second;
+
+		/* 9999-12-31T23:59:59Z */
+		static constexpr uint64_t MAX_SECONDS = 253402300799ull;
+
+		uint64_t seconds() const
+		{
+			/* years start in March, which puts the leap day at the end */
+			uint64_t const y   = year - (month <= 2);
+			uint64_t const era = y / 400;
+			uint64_t const yoe = y - era * 400;
+			uint64_t const doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5
+			                   + day - 1;
+			uint64_t const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+			/* 719468 days from 0000-03-01 to 1970-01-01 */
+			uint64_t const days = era * 146097 + doe - 719468;
+
+			return days * 86400 + hour * 3600 + minute * 60 + second;
+		}
+
+		static Civil_time from_seconds(uint64_t const seconds)
+		{
+			uint64_t const days = seconds / 86400 + 719468;
+			unsigned const secs = unsigned(seconds % 86400);
+
+			uint64_t const era = days / 146097;
+			uint64_t const doe = days - era * 146097;
+			uint64_t const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+			uint64_t const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+			uint64_t const mp  = (5 * doy + 2) / 153;
+
+			unsigned const month = unsigned(mp < 10 ? mp + 3 : mp - 9);
+
+			return Civil_time {
+				.year   = unsigned(yoe + era * 400 + (month <= 2)),
+				.month  = month,
+				.day    = unsigned(doy - (153 * mp + 2) / 5 + 1),
+				.hour   = secs / 3600,
+				.minute = secs / 60 % 60,
+				.second = secs % 60 };
+		}
+	};
+} /* namespace Utils */
+
+#endif /* _GENODIANS__CIVIL_TIME_H_ */
@@ -0,0 +1,279 @@
+/*
+ * \brief  Configuration of the genodians manager
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__CONFIG_H_
+#define _GENODIANS__CONFIG_H_
+
+/* local includes */
+#include <genodians/types.h>
+
+namespace Genodians {
+
+	struct Config
+	{
+		struct Child
+		{
+			Ram_quota ram;
+			Cap_quota caps;
+
+			static Child from_node(Node const &node)
+			{
+				return Child {
+					.ram = Ram_quota {
+						node.attribute_value("ram", Number_of_bytes(48u << 20)) },
+					.caps = Cap_quota {
+						node.attribute_value("caps", 300u) }
+				};
+			}
+
+			bool operator != (Child const &other) const {
+				return ram.value != other.ram.value || caps.value != other.caps.value; }
+		};
+
+		struct Lighttpd
+		{
+			/*
+			 * Performance-relevant settings of the web server
+			 *
+			 * A value of 0 leaves the setting at lighttpd's default.
+			 */
+			struct Profile
+			{
+				using Name = String<16>;
+
+				Name            event_handler;
+				Name            network_backend;
+				unsigned        max_fds;
+				unsigned        max_connections;
+				unsigned        max_keep_alive_requests;
+				unsigned        max_keep_alive_idle;
+				unsigned        max_read_idle;
+				unsigned        max_write_idle;
+				Number_of_bytes max_request_size;
+				Number_of_bytes chunkqueue_chunk_size;
+
+				static Profile from_node(Node const &node)
+				{
+					return Profile {
+						.event_handler =
+							node.attribute_value("event_handler", Name("select")),
+						.network_backend =
+							node.attribute_value("network_backend", Name("write")),
+						.max_fds =
+							node.attribute_value("max_fds", 128u),
+						.max_connections =
+							node.attribute_value("max_connections", 0u),
+						.max_keep_alive_requests =
+							node.attribute_value("max_keep_alive_requests", 4u),
+						.max_keep_alive_idle =
+							node.attribute_value("max_keep_alive_idle", 4u),
+						.max_read_idle =
+							node.attribute_value("max_read_idle", 0u),
+						.max_write_idle =
+							node.attribute_value("max_write_idle", 0u),
+						.max_request_size =
+							node.attribute_value("max_request_size", Number_of_bytes(0)),
+						.chunkqueue_chunk_size =
+							node.attribute_value("chunkqueue_chunk_size", Number_of_bytes(0))
+					};
+				}
+
+				bool operator != (Profile const &other) const
+				{
+					return event_handler           != other.event_handler
+					    || network_backend         != other.network_backend
+					    || max_fds                 != other.max_fds
+					    || max_connections         != other.max_connections
+					    || max_keep_alive_requests != other.max_keep_alive_requests
+					    || max_keep_alive_idle     != other.max_keep_alive_idle
+					    || max_read_idle           != other.max_read_idle
+					    || max_write_idle          != other.max_write_idle
+					    || max_request_size        != other.max_request_size
+					    || chunkqueue_chunk_size   != other.chunkqueue_chunk_size;
+				}
+
+				/*
+				 * Generate lighttpd configuration statements, one per line
+				 */
+				void for_each_conf_line(auto const &fn) const
+				{
+					using Line = String<80>;
+
+					fn(Line("server.event-handler   = \"", event_handler, "\""));
+					fn(Line("server.network-backend = \"", network_backend, "\""));
+					fn(Line("server.max-fds = ", max_fds));
+					fn(Line("server.max-keep-alive-requests = ", max_keep_alive_requests));
+					fn(Line("server.max-keep-alive-idle = ", max_keep_alive_idle));
+
+					if (max_connections)
+						fn(Line("server.max-connections = ", max_connections));
+					if (max_read_idle)
+						fn(Line("server.max-read-idle = ", max_read_idle));
+					if (max_write_idle)
+						fn(Line("server.max-write-idle = ", max_write_idle));
+
+					/* lighttpd expects the request-size limit in KiB */
+					if (max_request_size)
+						fn(Line("server.max-request-size = ",
+						        max(size_t(max_request_size) / 1024, size_t(1))));
+					if (chunkqueue_chunk_size)
+						fn(Line("server.chunkqueue-chunk-sz = ",
+						        size_t(chunkqueue_chunk_size)));
+				}
+			};
+
+			/*
+			 * Criteria for restarting lighttpd based on the latency probe
+			 */
+			struct Probe
+			{
+				unsigned latency_p99_ms;
+				unsigned degraded_rounds;
+				unsigned failed_rounds;
+
+				static Probe from_node(Node const &node)
+				{
+					/* a value of 0 would restart lighttpd on each probe round */
+					auto positive = [&] (char const *attr, unsigned const default_value)
+					{
+						unsigned const value = node.attribute_value(attr, default_value);
+						if (value)
+							return value;
+
+						warning("probe ", attr, "=\"0\" is invalid, using 1");
+						return 1u;
+					};
+
+					return Probe {
+						.latency_p99_ms  = positive("latency_p99_ms", 1000u),
+						.degraded_rounds = positive("degraded_rounds", 30u),
+						.failed_rounds   = positive("failed_rounds", 3u)
+					};
+				}
+			};
+
+			Child    lighttpd;
+			unsigned heartbeat_ms;
+			Profile  profile;
+			Probe    probe;
+
+			/* serve the website from a RAM copy taken at start time */
+			bool     snapshot;
+
+			static Lighttpd from_node(Node const &node)
+			{
+				return Lighttpd {
+					.lighttpd     = Child::from_node(node),
+					.heartbeat_ms = node.attribute_value("heartbeat_ms", 3000u),
+					.profile      = Profile::from_node(node),
+					.probe        = node.with_sub_node("probe",
+						[&] (Node const &node) { return Probe::from_node(node); },
+						[&]                    { return Probe::from_node(Node()); }),
+					.snapshot     = node.attribute_value("snapshot", false)
+				};
+			}
+		};
+
+		struct Import
+		{
+			Child    fetchurl;
+			Child    wipe;
+			Child    extract;
+			Child    generate;
+			unsigned sleep_duration;
+			unsigned initial_delay;
+			unsigned heartbeat_ms;
+			unsigned trace_cycles;
+			bool     log_cycles;
+		};
+
+		unsigned        status_update_interval;
+		unsigned        status_min_interval_ms;
+		Number_of_bytes status_buffer_size;
+
+		Lighttpd lighttpd_config;
+		Import   import_config;
+
+		static Config update_from_node(Node const &config_node)
+		{
+			unsigned const status_update_interval =
+				config_node.attribute_value("status_update_interval_sec", 60u);
+			unsigned const status_min_interval_ms =
+				config_node.attribute_value("status_min_interval_ms", 10'000u);
+			Number_of_bytes const status_buffer_size =
+				config_node.attribute_value("status_buffer_size",
+				                            Number_of_bytes(16u << 10));
+
+			Lighttpd const lighttpd_config =
+				config_node.with_sub_node("lighttpd",
+					[&] (Node const &node) { return Lighttpd::from_node(node); },
+					[&]                    { return Lighttpd::from_node(Node()); });
+
+			Import const import_config =
+				config_node.with_sub_node("import",
+					[&] (Node const &node) {
+
+						unsigned const import_heartbeat_ms =
+							node.attribute_value("heartbeat_ms", 3000u);
+						unsigned const sleep_duration =
+							node.attribute_value("update_interval_min", 180u);
+						unsigned const initial_delay =
+							node.attribute_value("initial_delay_min", 0u);
+						unsigned const trace_cycles =
+							node.attribute_value("trace_cycles", 3u);
+						bool const log_cycles =
+							node.attribute_value("log_cycles", false);
+
+						Child const fetchurl =
+							node.with_sub_node("fetchurl",
+								[&] (Node const &node) { return Child::from_node(node); },
+								[&]                    { return Child::from_node(Node()); });
+						Child const wipe =
+							node.with_sub_node("wipe",
+								[&] (Node const &node) { return Child::from_node(node); },
+								[&]                    { return Child::from_node(Node()); });
+						Child const extract =
+							node.with_sub_node("extract",
+								[&] (Node const &node) { return Child::from_node(node); },
+								[&]                    { return Child::from_node(Node()); });
+						Child const generate =
+							node.with_sub_node("generate",
+								[&] (Node const &node) { return Child::from_node(node); },
+								[&]                    { return Child::from_node(Node()); });
+
+						return Import {
+							.fetchurl       = fetchurl,
+							.wipe           = wipe,
+							.extract        = extract,
+							.generate       = generate,
+							.sleep_duration = sleep_duration,
+							.initial_delay  = initial_delay,
+							.heartbeat_ms   = import_heartbeat_ms,
+							.trace_cycles   = trace_cycles,
+							.log_cycles     = log_cycles
+						};
+					},
+					[&] { return Import { }; });
+
+			return Config {
+				.status_update_interval = status_update_interval,
+				.status_min_interval_ms = status_min_interval_ms,
+				.status_buffer_size     = status_buffer_size,
+				.lighttpd_config = lighttpd_config,
+				.import_config   = import_config
+			};
+		}
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__CONFIG_H_ */
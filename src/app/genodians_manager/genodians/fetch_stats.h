@@ -0,0 +1,170 @@
+/*
+ * \brief  Statistics of the fetchurl downloads
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__FETCH_STATS_H_
+#define _GENODIANS__FETCH_STATS_H_
+
+/* local includes */
+#include <genodians/types.h>
+
+namespace Genodians {
+
+	/*
+	 * Download statistics of the archives fetched by the current or last
+	 * FETCH step
+	 *
+	 * The statistics are derived from the progress report of fetchurl,
+	 * which is only updated at the report interval. A download is assumed
+	 * to have started right after the last report that showed it idle.
+	 */
+	struct Fetch_stats
+	{
+		/* one archive per author */
+		static constexpr unsigned MAX_ARCHIVES = 64;
+
+		using Url  = String<256>;
+		using Name = Html::String;
+
+		struct Archive
+		{
+			Url      url      { };
+			Name     name     { };
+			uint64_t bytes    = 0;
+			uint64_t start_ms = 0;
+			uint64_t end_ms   = 0;
+			bool     active   = false;
+			bool     finished = false;
+			bool     failed   = false;
+
+			Duration_ms duration(uint64_t now_ms) const {
+				return { active ? (finished ? end_ms : now_ms) - start_ms : 0 }; }
+
+			/* bytes per second */
+			uint64_t throughput(uint64_t now_ms) const
+			{
+				uint64_t const ms = duration(now_ms).value;
+				return ms ? bytes*1000/ms : 0;
+			}
+		};
+
+		Archive  _archives[MAX_ARCHIVES] { };
+		unsigned _num_archives   = 0;
+		uint64_t _last_report_ms = 0;
+
+		void reset(uint64_t now_ms)
+		{
+			_num_archives   = 0;
+			_last_report_ms = now_ms;
+		}
+
+		/*
+		 * Apply progress report, 'name_fn' maps the URL to the archive name
+		 */
+		void update(Node const &progress, uint64_t now_ms, auto const &name_fn)
+		{
+			progress.for_each_sub_node("fetch", [&] (Node const &node) {
+
+				Url const url = node.attribute_value("url", Url());
+
+				Archive *archive = nullptr;
+				for (unsigned i = 0; i < _num_archives; i++)
+					if (_archives[i].url == url)
+						archive = &_archives[i];
+
+				if (!archive) {
+					if (_num_archives == MAX_ARCHIVES)
+						return;
+					archive = &_archives[_num_archives++];
+					*archive = { };
+					archive->url  = url;
+					archive->name = name_fn(url);
+				}
+
+				if (archive->finished)
+					return;
+
+				/* fetchurl reports the progress as floating-point values */
+				uint64_t const bytes    = uint64_t(node.attribute_value("now", 0.0));
+				bool     const finished = node.attribute_value("finished", false);
+
+				if (!archive->active && (bytes || finished)) {
+					archive->active   = true;
+					archive->start_ms = _last_report_ms;
+				}
+
+				archive->bytes = bytes;
+
+				if (finished) {
+					archive->finished = true;
+					archive->failed   = node.attribute_value("result", String<16>()) != "success";
+					archive->end_ms   = now_ms;
+				}
+			});
+
+			_last_report_ms = now_ms;
+		}
+
+		/*
+		 * Close downloads whose completion was not reported before fetchurl exited
+		 */
+		void complete(uint64_t now_ms)
+		{
+			for (unsigned i = 0; i < _num_archives; i++) {
+				Archive &archive = _archives[i];
+				if (archive.active && !archive.finished) {
+					archive.finished = true;
+					archive.end_ms   = now_ms;
+				}
+			}
+		}
+
+		uint64_t total_bytes() const
+		{
+			uint64_t result = 0;
+			for (unsigned i = 0; i < _num_archives; i++)
+				result += _archives[i].bytes;
+			return result;
+		}
+
+		bool empty() const { return _num_archives == 0; }
+
+		void for_each_archive(auto const &fn) const
+		{
+			for (unsigned i = 0; i < _num_archives; i++)
+				fn(_archives[i]);
+		}
+
+		/*
+		 * Call 'fn' for each archive, the longest download first
+		 */
+		void for_each_by_duration(uint64_t now_ms, auto const &fn) const
+		{
+			unsigned order[MAX_ARCHIVES];
+			for (unsigned i = 0; i < _num_archives; i++) {
+				unsigned j = i;
+				for (; j > 0; j--) {
+					if (_archives[order[j - 1]].duration(now_ms).value
+					 >= _archives[i].duration(now_ms).value)
+						break;
+					order[j] = order[j - 1];
+				}
+				order[j] = i;
+			}
+
+			for (unsigned i = 0; i < _num_archives; i++)
+				fn(_archives[order[i]]);
+		}
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__FETCH_STATS_H_ */
@@ -0,0 +1,71 @@
+/*
+ * \brief  Histogram with fixed bucket bounds
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__HISTOGRAM_H_
+#define _GENODIANS__HISTOGRAM_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+
+namespace Utils {
+
+	using Genode::uint64_t;
+
+	/*
+	 * Histogram with fixed bucket bounds
+	 */
+	template <unsigned N>
+	struct Histogram
+	{
+		using Bounds = uint64_t[N];
+
+		Bounds const &_bounds;
+
+		uint64_t _buckets[N + 1] { };
+		uint64_t _count = 0;
+		uint64_t _sum   = 0;
+
+		Histogram(Bounds const &bounds) : _bounds { bounds } { }
+
+		void observe(uint64_t const value)
+		{
+			unsigned i = 0;
+			while (i < N && value > _bounds[i])
+				i++;
+
+			_buckets[i]++;
+			_count++;
+			_sum += value;
+		}
+
+		uint64_t count() const { return _count; }
+		uint64_t sum()   const { return _sum; }
+
+		/*
+		 * Call 'fn' with the upper bound and the cumulative count of
+		 * each bounded bucket
+		 *
+		 * The count of the unbounded last bucket equals 'count()'.
+		 */
+		void for_each_bucket(auto const &fn) const
+		{
+			uint64_t cumulative = 0;
+			for (unsigned i = 0; i < N; i++) {
+				cumulative += _buckets[i];
+				fn(_bounds[i], cumulative);
+			}
+		}
+	};
+} /* namespace Utils */
+
+#endif /* _GENODIANS__HISTOGRAM_H_ */
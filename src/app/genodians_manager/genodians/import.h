@@ -0,0 +1,451 @@
+/*
+ * \brief  Import of the content and generation of the website
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__IMPORT_H_
+#define _GENODIANS__IMPORT_H_
+
+/* Genode includes */
+#include <log_session/log_session.h>
+#include <rtc_session/connection.h>
+#include <timer_session/connection.h>
+
+/* local includes */
+#include <genodians/config.h>
+#include <genodians/fetch_stats.h>
+#include <genodians/import_trace.h>
+#include <genodians/managed_init.h>
+#include <genodians/text_reporter.h>
+
+namespace Genodians {
+
+	struct Fetch;
+	struct Wipe;
+	struct Extract;
+	struct Generate;
+	struct Import;
+}
+
+
+struct Genodians::Fetch : Genodians::Managed_child
+{
+	Fetch(Managed_init::Child_state_registery &registry,
+	      Config::Child                 const &config)
+	:
+		Managed_child { registry, "fetchurl",
+		                Priority  { 0 },
+		                config.ram, config.caps }
+	{ }
+
+	/*****************************
+	 ** Managed_child interface **
+	 *****************************/
+
+	void generate(Generator &g) const override
+	{
+		g.node("start", [&] {
+			gen_start_node_content(g);
+
+			g.node("heartbeat", [&] { });
+
+			g.node("route", [&] {
+				gen_service_node<Rom_session>(g, [&] {
+					g.attribute("label", "config");
+					g.node("parent", [&] {
+						g.attribute("label", "fetchurl.config"); }); });
+				gen_service_node<Nic::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_service_node<File_system::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_service_node<Timer::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_service_node<Report::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_common_parent_routes(g);
+			});
+		});
+	}
+};
+
+
+struct Genodians::Wipe : Genodians::Managed_child
+{
+	Wipe(Managed_init::Child_state_registery &registry,
+	     Config::Child                 const &config)
+	:
+		Managed_child { registry, "wipe",
+		                Priority  { 0 },
+		                config.ram, config.caps }
+	{ }
+
+	/*****************************
+	 ** Managed_child interface **
+	 *****************************/
+
+	void generate(Generator &g) const override
+	{
+		g.node("start", [&] {
+			gen_start_node_content(g);
+			gen_named_node(g, "binary", "init");
+
+			g.node("heartbeat", [&] { });
+
+			g.node("route", [&] {
+				gen_service_node<Rom_session>(g, [&] {
+					g.attribute("label", "config");
+					g.node("parent", [&] {
+						g.attribute("label", "wipe.config"); }); });
+				gen_service_node<File_system::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_service_node<Timer::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_common_parent_routes(g);
+			});
+		});
+	}
+};
+
+
+struct Genodians::Extract : Genodians::Managed_child
+{
+	Extract(Managed_init::Child_state_registery &registry,
+	        Config::Child                 const &config)
+	:
+		Managed_child { registry, "extract",
+		                Priority  { 0 },
+		                config.ram, config.caps }
+	{ }
+
+	/*****************************
+	 ** Managed_child interface **
+	 *****************************/
+
+	void generate(Generator &g) const override
+	{
+		g.node("start", [&] {
+			gen_start_node_content(g);
+
+			g.node("heartbeat", [&] { });
+
+			g.node("route", [&] {
+				gen_service_node<File_system::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_service_node<Rom_session>(g, [&] {
+					g.attribute("label", "config");
+					g.node("parent", [&] {
+						g.attribute("label", "extract.config"); }); });
+				gen_common_parent_routes(g);
+			});
+		});
+	}
+};
+
+
+struct Genodians::Generate : Genodians::Managed_child
+{
+	Generate(Managed_init::Child_state_registery &registry,
+	         Config::Child                 const &config)
+	:
+		Managed_child { registry, "generate",
+		                Priority  { 0 },
+		                config.ram, config.caps }
+	{ }
+
+	/*****************************
+	 ** Managed_child interface **
+	 *****************************/
+
+	void generate(Generator &g) const override
+	{
+		g.node("start", [&] {
+			gen_start_node_content(g);
+
+			gen_named_node(g, "binary", "init");
+			g.node("heartbeat", [&] { });
+
+			g.node("route", [&] {
+				gen_service_node<Rom_session>(g, [&] {
+					g.attribute("label", "config");
+					g.node("parent", [&] {
+						g.attribute("label", "generate.config"); }); });
+				gen_service_node<File_system::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_service_node<Timer::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_service_node<Rtc::Session>(g, [&] {
+					g.node("parent", [&] { }); });
+				gen_common_parent_routes(g);
+			});
+		});
+	}
+};
+
+
+struct Genodians::Import : Genodians::Managed_init
+{
+	Env &_env;
+
+	Timer::Connection &_timer;
+	Rtc::Connection   &_rtc;
+
+	enum class State {
+		INVALID, INIT, FETCH, WIPE, EXTRACT, GENERATE, SLEEP };
+
+	State _state;
+
+	Constructible<Fetch>    _fetch    { };
+	Constructible<Wipe>     _wipe     { };
+	Constructible<Extract>  _extract  { };
+	Constructible<Generate> _generate { };
+
+	uint64_t _now_ms() const {
+		return _timer.curr_time().trunc_to_plain_ms().value; }
+
+	Duration_ms _last_fetch_duration    {  60'000u };
+	Duration_ms _last_wipe_duration     {  15'000u };
+	Duration_ms _last_extract_duration  {  15'000u };
+	Duration_ms _last_generate_duration { 180'000u };
+
+	/* bucket bounds of the duration histograms in milliseconds */
+	static constexpr uint64_t _duration_bounds[] = {
+		100, 500, 1'000, 5'000, 15'000, 30'000, 60'000, 120'000,
+		300'000, 600'000, 1'800'000, 3'600'000 };
+
+	using Duration_histogram = Histogram<sizeof(_duration_bounds)/sizeof(uint64_t)>;
+
+	Duration_histogram _fetch_durations    { _duration_bounds };
+	Duration_histogram _wipe_durations     { _duration_bounds };
+	Duration_histogram _extract_durations  { _duration_bounds };
+	Duration_histogram _generate_durations { _duration_bounds };
+	Duration_histogram _import_durations   { _duration_bounds };
+
+	/*
+	 * Step timeout handling
+	 */
+
+	Seconds _calculate_timeout(Seconds const secs,
+	                           Seconds const min = { .value = 15u }) const
+	{
+		/* some steps take normally at most a few seconds */
+		Seconds const min_duration = { max(secs.value / 2, min.value) };
+
+		return { secs.value + min_duration.value };
+	}
+
+	Seconds _step_timeout_secs { 0 };
+	bool    _step_timeout_triggered = false;
+
+	Timer::One_shot_timeout<Import> _step_timeout {
+		_timer, *this, &Import::_handle_step_timeout };
+
+	void _handle_step_timeout(Duration)
+	{
+		_step_timeout_triggered = true;
+		warning("timeout triggered for step ", _step_name(_state));
+
+		with_init_state([&] (Init_state const &state) {
+			state_update(state, false); }, [&] { });
+	}
+
+	/*
+	 * Sleep timeout handling
+	 */
+
+	bool _sleep_timeout_triggered = false;
+
+	Timer::One_shot_timeout<Import> _sleep_timeout {
+		_timer, *this, &Import::_handle_sleep_timeout };
+
+	void _handle_sleep_timeout(Duration)
+	{
+		_sleep_timeout_triggered = true;
+
+		/* the import init lacks a valid state before the first import */
+		with_init_state([&] (Init_state const &state) {
+			state_update(state, false); }, [&] {
+			state_update(Init_state { }, false); });
+	}
+
+	void _update_init_config(Generator &g);
+
+	Config::Import const &_config;
+
+	Notify_interface &_website_update_notifier;
+
+	Date _last_update { };
+	Date _next_update { };
+
+	uint64_t    _import_start_ms      = 0;
+	uint64_t    _import_step_start_ms = 0;
+	Duration_ms _import_duration      { 0 };
+	unsigned    _imports              = 0;
+
+	/* start of the ongoing sleep period, which is the initial delay if set */
+	uint64_t _sleep_start_ms = 0;
+	bool     _initial_sleep  = false;
+
+	unsigned _sleep_minutes(Config::Import const &config) const {
+		return _initial_sleep ? config.initial_delay : config.sleep_duration; }
+
+	static char const *_step_name(State state)
+	{
+		switch (state) {
+		case State::FETCH:    return "fetch";
+		case State::WIPE:     return "wipe";
+		case State::EXTRACT:  return "extract";
+		case State::GENERATE: return "generate";
+		default:              return nullptr;
+		}
+	}
+
+	/*
+	 * Log the outcome of the current step in a machine-readable form,
+	 * e.g., for run/genodians_bench.run
+	 */
+	void _log_step(Managed_child const &child, Duration_ms duration) const
+	{
+		if (!_config.log_cycles)
+			return;
+
+		log("import step=", _step_name(_state), " cycle=", _imports + 1,
+		    " duration_ms=", duration.value,
+		    " ram_peak=", child.peak_ram(), " caps_peak=", child.peak_caps());
+	}
+
+	/*
+	 * Trace of the recent import cycles, reported as JSON
+	 */
+	Import_trace _trace { };
+
+	Text_reporter _trace_reporter { _env, "trace", "import_trace.json", 16u << 10 };
+
+	void _report_trace()
+	{
+		_trace_reporter.generate([&] (Output &out) {
+			_trace.generate(out, _config.trace_cycles); });
+	}
+
+	/*
+	 * Per-archive download statistics of the FETCH step
+	 */
+	Fetch_stats _fetch_stats { };
+
+	Attached_rom_dataspace _fetchurl_config_rom { _env, "fetchurl.config" };
+
+	Rom_handler<Import> _fetch_progress_rom;
+
+	/* name the archive after the author, i.e., the download path sans '.zip' */
+	Fetch_stats::Name _archive_name(Fetch_stats::Url const &url) const
+	{
+		using Path = String<128>;
+
+		Path path { };
+		_fetchurl_config_rom.node().for_each_sub_node("fetch", [&] (Node const &fetch) {
+			if (fetch.attribute_value("url", Fetch_stats::Url()) == url)
+				path = fetch.attribute_value("path", Path()); });
+
+		if (!path.valid())
+			return Fetch_stats::Name(url);
+
+		char const *name = path.string();
+		for (char const *s = name; *s; s++)
+			if (*s == '/') name = s + 1;
+
+		size_t len = strlen(name);
+		if (len > 4 && strcmp(name + len - 4, ".zip") == 0)
+			len -= 4;
+
+		return Fetch_stats::Name(Cstring(name, len));
+	}
+
+	void _handle_fetch_progress(Node const &node)
+	{
+		if (_state != State::FETCH)
+			return;
+
+		_fetch_stats.update(node, _now_ms(), [&] (Fetch_stats::Url const &url) {
+			return _archive_name(url); });
+
+		_state_change_notifier.notify();
+	}
+
+	Import(Env                  &env,
+	       Notify_interface     &notify,
+	       Notify_interface     &website_update_notify,
+	       Timer::Connection    &timer,
+	       Rtc::Connection      &rtc,
+	       Config::Import const &config)
+	:
+		Managed_init { env, notify,
+		               "import.state", "import.config" },
+		_env         { env },
+		_timer       { timer },
+		_rtc         { rtc },
+		_state       { State::INIT },
+		_config      { config },
+		_website_update_notifier { website_update_notify },
+		_fetch_progress_rom { env, "fetchurl.progress", *this,
+		                      &Import::_handle_fetch_progress }
+	{
+		/* initial Rom_handler signal will get us started */
+		if (!_config.initial_delay)
+			return;
+
+		/* serve the website restored at boot for a while */
+		uint64_t const delay_secs = 60ull * _config.initial_delay;
+
+		_state          = State::SLEEP;
+		_initial_sleep  = true;
+		_sleep_start_ms = _now_ms();
+		_sleep_timeout.schedule(Microseconds { 1'000'000ull * delay_secs });
+
+		Seconds const current_secs = Seconds::from_rtc(_rtc.current_time());
+		_next_update = Utils::from_rtc(from_seconds({ current_secs.value + delay_secs }));
+	}
+
+	void _generate_fetch_report(Xml_generator &) const;
+
+	/*
+	 * Apply a configuration update, '_config' already holds the new values
+	 *
+	 * Changed quotas take effect with the next start of the respective
+	 * step.
+	 */
+	void apply_config(Config::Import const &old)
+	{
+		if (old.heartbeat_ms != _config.heartbeat_ms)
+			Managed_init::generate_config([&] (Generator &g) {
+				_update_init_config(g); });
+
+		if (_state != State::SLEEP || _sleep_minutes(old) == _sleep_minutes(_config))
+			return;
+
+		uint64_t const interval_ms = 60'000ull * _sleep_minutes(_config);
+		uint64_t const elapsed_ms  = _now_ms() - _sleep_start_ms;
+		uint64_t const remain_ms   = interval_ms > elapsed_ms ? interval_ms - elapsed_ms : 1;
+
+		_sleep_timeout.schedule(Microseconds { 1'000ull * remain_ms });
+
+		Seconds const current_secs = Seconds::from_rtc(_rtc.current_time());
+		_next_update = Utils::from_rtc(from_seconds({ current_secs.value + remain_ms / 1000 }));
+	}
+
+	/****************************
+	 ** Managed_init interface **
+	 ****************************/
+
+	void generate_report (Xml_generator &xml)           const override;
+	void generate_metrics(Metrics &)                    const override;
+	void state_update    (Init_state const &, bool)     override;
+};
+
+#endif /* _GENODIANS__IMPORT_H_ */
@@ -0,0 +1,108 @@
+/*
+ * \brief  Trace of the import cycles
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__IMPORT_TRACE_H_
+#define _GENODIANS__IMPORT_TRACE_H_
+
+/* local includes */
+#include <genodians/types.h>
+
+namespace Genodians {
+
+	/*
+	 * Events of the recent import cycles
+	 *
+	 * The events are exported in the trace-event format understood by
+	 * the Chrome trace viewer and Perfetto.
+	 */
+	struct Import_trace
+	{
+		enum class Type {
+			CYCLE_BEGIN, CYCLE_END, STEP_BEGIN, STEP_END, STEP_FAILED,
+			TIMEOUT, RESTART, QUOTA_UPGRADE };
+
+		struct Event
+		{
+			Type        type;
+			uint64_t    time_ms;
+			unsigned    cycle;
+			char const *name;
+		};
+
+		static constexpr unsigned MAX_EVENTS = 256;
+
+		Ring_buffer<Event, MAX_EVENTS> _events { };
+
+		unsigned _cycle = 0;
+
+		void begin_cycle(uint64_t now_ms)
+		{
+			_cycle++;
+			record(Type::CYCLE_BEGIN, now_ms, "import");
+		}
+
+		void record(Type type, uint64_t now_ms, char const *name) {
+			_events.add({ type, now_ms, _cycle, name }); }
+
+		/*
+		 * Generate JSON trace covering the last 'max_cycles' cycles
+		 */
+		void generate(Output &out, unsigned max_cycles) const
+		{
+			auto phase = [] (Type type) {
+				switch (type) {
+				case Type::CYCLE_BEGIN:
+				case Type::STEP_BEGIN:  return "B";
+				case Type::CYCLE_END:
+				case Type::STEP_END:
+				case Type::STEP_FAILED: return "E";
+				default:                return "i";
+				}
+			};
+
+			auto suffix = [] (Type type) {
+				switch (type) {
+				case Type::TIMEOUT:       return " timeout";
+				case Type::RESTART:       return " restart";
+				case Type::QUOTA_UPGRADE: return " quota upgrade";
+				default:                  return "";
+				}
+			};
+
+			print(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+			bool first = true;
+			_events.for_each([&] (Event const &event) {
+				if (event.cycle + max_cycles <= _cycle)
+					return;
+
+				print(out, first ? "" : ",", "\n{\"name\":\"", event.name,
+				      suffix(event.type), "\",\"cat\":\"import\",",
+				      "\"ph\":\"", phase(event.type), "\",",
+				      "\"ts\":", event.time_ms*1000, ",\"pid\":1,\"tid\":1,");
+
+				if (Genode::strcmp(phase(event.type), "i") == 0)
+					print(out, "\"s\":\"t\",");
+
+				print(out, "\"args\":{\"cycle\":", event.cycle,
+				      event.type == Type::STEP_FAILED ? ",\"result\":\"failed\"" : "",
+				      "}}");
+				first = false;
+			});
+
+			print(out, "\n]}\n");
+		}
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__IMPORT_TRACE_H_ */
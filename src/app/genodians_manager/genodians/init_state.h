@@ -0,0 +1,169 @@
+/*
+ * \brief  Parsed subset of an init state report
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__INIT_STATE_H_
+#define _GENODIANS__INIT_STATE_H_
+
+/* local includes */
+#include <genodians/child_progress.h>
+#include <genodians/types.h>
+
+namespace Genodians {
+
+	/*
+	 * Parsed subset of an init state report
+	 *
+	 * Only the values needed for supervising the children and for the
+	 * status page are kept in a fixed-size structure. In contrast to
+	 * buffering the whole report, this does not consume any heap.
+	 */
+	struct Init_state
+	{
+		struct Resources
+		{
+			Number_of_bytes ram_quota  { 0 };
+			Number_of_bytes ram_avail  { 0 };
+			unsigned long   caps_quota { 0 };
+			unsigned long   caps_avail { 0 };
+
+			static Resources from_node(Node const &node)
+			{
+				Resources result { };
+				node.with_optional_sub_node("ram", [&] (Node const &ram) {
+					result.ram_quota = ram.attribute_value("quota", Number_of_bytes(0));
+					result.ram_avail = ram.attribute_value("avail", Number_of_bytes(0)); });
+				node.with_optional_sub_node("caps", [&] (Node const &caps) {
+					result.caps_quota = caps.attribute_value("quota", 0ul);
+					result.caps_avail = caps.attribute_value("avail", 0ul); });
+				return result;
+			}
+
+			bool operator != (Resources const &other) const
+			{
+				return ram_quota  != other.ram_quota
+				    || ram_avail  != other.ram_avail
+				    || caps_quota != other.caps_quota
+				    || caps_avail != other.caps_avail;
+			}
+		};
+
+		struct Child
+		{
+			Start_name name { };
+			Resources  resources { };
+			bool       exited = false;
+			int        exit_code = 0;
+			unsigned   skipped_heartbeats = 0;
+
+			bool responsive() const {
+				return Child_progress::responsive(skipped_heartbeats); }
+
+			Child_progress progress() const {
+				return Child_progress::listed(exited, exit_code, skipped_heartbeats); }
+
+			bool operator != (Child const &other) const
+			{
+				return name               != other.name
+				    || resources          != other.resources
+				    || exited             != other.exited
+				    || exit_code          != other.exit_code
+				    || skipped_heartbeats != other.skipped_heartbeats;
+			}
+		};
+
+		/* each managed init hosts only a few children at a time */
+		static constexpr unsigned MAX_CHILDREN = 8;
+
+		bool      valid = false;
+		Resources init { };
+		Child     children[MAX_CHILDREN] { };
+		unsigned  num_children = 0;
+
+		/* children of the report beyond 'MAX_CHILDREN', which are not kept */
+		unsigned  num_dropped = 0;
+
+		/* position of each child within 'children' */
+		Name_index<Start_name, unsigned, MAX_CHILDREN> _index { };
+
+		/*
+		 * Parse the report in a single pass
+		 *
+		 * The 'child_fn' is called with each '<child>' node of the report
+		 * and its name, which allows for evaluating further attributes
+		 * without traversing the report once more. Children beyond
+		 * 'MAX_CHILDREN' are merely counted in 'num_dropped'.
+		 */
+		static Init_state from_node(Node const &node, auto const &child_fn)
+		{
+			Init_state state { };
+			state.valid = true;
+			state.init  = Resources::from_node(node);
+
+			node.for_each_sub_node("child", [&] (Node const &child) {
+
+				Start_name const name = child.attribute_value("name", Start_name());
+				child_fn(child, name);
+
+				if (state.num_children == MAX_CHILDREN) {
+					state.num_dropped++;
+					return;
+				}
+				Child &c = state.children[state.num_children];
+
+				c.name               = name;
+				c.resources          = Resources::from_node(child);
+				c.exited             = child.has_attribute("exited");
+				c.exit_code          = child.attribute_value("exited", 0);
+				c.skipped_heartbeats = child.attribute_value("skipped_heartbeats", 0u);
+
+				state._index.insert(name, state.num_children++);
+			});
+			return state;
+		}
+
+		static Init_state from_node(Node const &node) {
+			return from_node(node, [] (Node const &, Start_name const &) { }); }
+
+		bool differs_from(Init_state const &other) const
+		{
+			if (valid        != other.valid
+			 || init         != other.init
+			 || num_children != other.num_children
+			 || num_dropped  != other.num_dropped)
+				return true;
+
+			for (unsigned i = 0; i < num_children; i++)
+				if (children[i] != other.children[i])
+					return true;
+
+			return false;
+		}
+
+		void for_each_child(auto const &fn) const
+		{
+			for (unsigned i = 0; i < num_children; i++)
+				fn(children[i]);
+		}
+
+		void with_child(Start_name const &name, auto const &fn,
+		                                        auto const &missing_fn) const
+		{
+			_index.with_value(name, [&] (unsigned const i) {
+				fn(children[i]); }, missing_fn);
+		}
+
+		void generate_report(Xml_generator &) const;
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__INIT_STATE_H_ */
@@ -0,0 +1,179 @@
+/*
+ * \brief  Evaluation of the lighttpd probe reports
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__LATENCY_PROBE_H_
+#define _GENODIANS__LATENCY_PROBE_H_
+
+/* local includes */
+#include <genodians/types.h>
+
+namespace Genodians {
+
+	/*
+	 * Evaluation of the rounds of the lighttpd latency probe
+	 *
+	 * The latencies of the successful requests are accumulated in a
+	 * histogram per URL and kept in a window of recent samples, from
+	 * which the p99 latency is determined. A round is considered
+	 * degraded if the p99 latency exceeds the threshold and the round
+	 * itself featured a slow request, i.e., the slowness is still
+	 * ongoing. A round is considered failed if any request failed.
+	 */
+	struct Latency_probe
+	{
+		/* bucket bounds of the latency histograms in milliseconds */
+		static constexpr uint64_t _latency_bounds[] = {
+			5, 10, 25, 50, 100, 250, 500, 1'000, 2'500, 5'000 };
+
+		using Latency_histogram = Histogram<sizeof(_latency_bounds)/sizeof(uint64_t)>;
+
+		static constexpr unsigned MAX_TARGETS = 8;
+
+		/* covers about 15 minutes of three URLs probed every 10 seconds */
+		static constexpr unsigned WINDOW = 256;
+
+		using Path   = String<64>;
+		using Result = String<16>;
+
+		struct Target
+		{
+			Path              path       { };
+			Latency_histogram latencies  { _latency_bounds };
+			uint64_t          latency_ms = 0;
+			unsigned          status     = 0;
+			Result            result     { };
+			Result            error      { };
+			uint64_t          failures   = 0;
+		};
+
+		Target   _targets[MAX_TARGETS] { };
+		unsigned _num_targets = 0;
+
+		Ring_buffer<uint32_t, WINDOW> _window { };
+
+		unsigned _round           = 0;
+		uint64_t _rounds          = 0;
+		unsigned _degraded_rounds = 0;
+		unsigned _failed_rounds   = 0;
+		uint32_t _p99_ms          = 0;
+
+		Target *_target(Path const &path)
+		{
+			for (unsigned i = 0; i < _num_targets; i++)
+				if (_targets[i].path == path)
+					return &_targets[i];
+
+			if (_num_targets == MAX_TARGETS)
+				return nullptr;
+
+			Target &target = _targets[_num_targets++];
+			target.path = path;
+			return &target;
+		}
+
+		uint32_t _percentile_99() const
+		{
+			/* insertion sort of the window */
+			uint32_t sorted[WINDOW];
+			unsigned n = 0;
+			_window.for_each([&] (uint32_t const latency) {
+				unsigned i = n++;
+				for (; i > 0 && sorted[i - 1] > latency; i--)
+					sorted[i] = sorted[i - 1];
+				sorted[i] = latency;
+			});
+
+			return n ? sorted[(n*99 + 99)/100 - 1] : 0;
+		}
+
+		enum class Verdict { HEALTHY, DEGRADED, FAILED };
+
+		/*
+		 * Evaluate the probe report, returns the state of the web server
+		 *
+		 * The 'criteria' correspond to 'Config::Lighttpd::Probe'. A report
+		 * of an already evaluated round leaves the state as is.
+		 */
+		Verdict update(Node const &report, auto const &criteria)
+		{
+			unsigned const round = report.attribute_value("round", 0u);
+
+			if (round && round != _round) {
+				_round = round;
+				_rounds++;
+
+				bool     failed     = false;
+				uint64_t slowest_ms = 0;
+
+				report.for_each_sub_node("target", [&] (Node const &node) {
+					Target *target = _target(node.attribute_value("path", Path()));
+					if (!target)
+						return;
+
+					target->latency_ms = node.attribute_value("latency_ms", 0ull);
+					target->status     = node.attribute_value("status",     0u);
+					target->result     = node.attribute_value("result",     Result());
+					target->error      = node.attribute_value("error",      Result());
+
+					if (target->result != "success") {
+						target->failures++;
+						failed = true;
+						return;
+					}
+
+					target->latencies.observe(target->latency_ms);
+					_window.add(uint32_t(min(target->latency_ms, uint64_t(~0u))));
+					slowest_ms = max(slowest_ms, target->latency_ms);
+				});
+
+				_p99_ms = _percentile_99();
+
+				bool const degraded = _p99_ms     > criteria.latency_p99_ms
+				                   && slowest_ms > criteria.latency_p99_ms;
+
+				_failed_rounds   = failed   ? _failed_rounds   + 1 : 0;
+				_degraded_rounds = degraded ? _degraded_rounds + 1 : 0;
+			}
+
+			if (_failed_rounds >= criteria.failed_rounds)
+				return Verdict::FAILED;
+			if (_degraded_rounds >= criteria.degraded_rounds)
+				return Verdict::DEGRADED;
+			return Verdict::HEALTHY;
+		}
+
+		/*
+		 * Start over after lighttpd got restarted
+		 */
+		void restart()
+		{
+			_window.clear();
+			_degraded_rounds = 0;
+			_failed_rounds   = 0;
+			_p99_ms          = 0;
+		}
+
+		uint64_t rounds()          const { return _rounds; }
+		uint32_t p99_ms()          const { return _p99_ms; }
+		unsigned degraded_rounds() const { return _degraded_rounds; }
+		unsigned failed_rounds()   const { return _failed_rounds; }
+
+		void for_each_target(auto const &fn) const
+		{
+			for (unsigned i = 0; i < _num_targets; i++)
+				fn(_targets[i]);
+		}
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__LATENCY_PROBE_H_ */
@@ -0,0 +1,186 @@
+/*
+ * \brief  Supervision of the lighttpd web server
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__LIGHTTPD_H_
+#define _GENODIANS__LIGHTTPD_H_
+
+/* Genode includes */
+#include <log_session/log_session.h>
+#include <rtc_session/connection.h>
+#include <timer_session/connection.h>
+
+/* local includes */
+#include <genodians/config.h>
+#include <genodians/managed_init.h>
+
+namespace Genodians { struct Lighttpd; }
+
+
+struct Genodians::Lighttpd : Genodians::Managed_init
+{
+	Env &_env;
+
+	Rtc::Connection &_rtc;
+
+	void _update_init_config(Generator &);
+
+	Config::Lighttpd const &_config;
+
+	/*
+	 * Start node of lighttpd
+	 *
+	 * The child state merely holds the quota including the upgrades
+	 * requested by lighttpd. The version of the start node is tracked
+	 * explicitly so that the child state can be constructed anew with a
+	 * changed quota, which init applies to the running child, without
+	 * affecting the version.
+	 */
+	struct Start
+	{
+		Managed_init::Child_state_registery &_registry;
+
+		Constructible<Child_state> _child_state { };
+
+		unsigned _version = 0;
+
+		void set_quota(Ram_quota ram, Cap_quota caps)
+		{
+			_child_state.construct(_registry, "lighttpd", Priority { 0 }, ram, caps);
+		}
+
+		Start(Managed_init::Child_state_registery &registry,
+		      Ram_quota ram, Cap_quota caps)
+		:
+			_registry { registry }
+		{
+			set_quota(ram, caps);
+		}
+
+		/*
+		 * Restart with the given quota, dropping former upgrades
+		 */
+		void restart(Ram_quota ram, Cap_quota caps)
+		{
+			_version++;
+			set_quota(ram, caps);
+		}
+
+		void gen_content(Generator &g) const
+		{
+			/* the child state is never restarted and has no version of its own */
+			if (_version)
+				g.attribute("version", _version);
+
+			_child_state->gen_start_node_content(g);
+		}
+	};
+
+	Start _start;
+
+	void _trigger_child_restart() {
+		_start.restart(_config.lighttpd.ram, _config.lighttpd.caps); }
+
+	Date     _last_restart { };
+	unsigned _restarts = 0;
+
+	Date     _last_snapshot { };
+	unsigned _snapshots = 0;
+
+	void _restart()
+	{
+		_restarts++;
+		_last_restart = from_rtc(_rtc.current_time());
+
+		Managed_init::generate_config([&] (Generator &g) {
+			_update_init_config(g); });
+	}
+
+	Lighttpd(Env                    &env,
+	         Notify_interface       &notify,
+	         Rtc::Connection        &rtc,
+	         Config::Lighttpd const &config)
+	:
+		Managed_init  { env, notify,
+		                "lighttpd.state", "lighttpd.config" },
+		_env          { env },
+		_rtc          { rtc },
+		_config       { config },
+		_start        { Managed_init::child_states,
+		                _config.lighttpd.ram, _config.lighttpd.caps }
+	{
+		/* initial init configuration */
+		Managed_init::generate_config([&] (Generator &g) {
+			_update_init_config(g); });
+	}
+
+	void trigger_restart()
+	{
+		_trigger_child_restart();
+		_restart();
+	}
+
+	/*
+	 * Apply a configuration update, '_config' already holds the new values
+	 *
+	 * Lighttpd is only restarted if the new configuration cannot be
+	 * applied otherwise.
+	 */
+	void apply_config(Config::Lighttpd const &old)
+	{
+		bool const quota_changed = old.lighttpd != _config.lighttpd;
+
+		/*
+		 * Init adapts the quota of the running child. The version of the
+		 * start node is retained to prevent a restart.
+		 */
+		if (quota_changed)
+			_start.set_quota(_config.lighttpd.ram, _config.lighttpd.caps);
+
+		/* the profile and the snapshot are evaluated at startup only */
+		if (old.profile != _config.profile || old.snapshot != _config.snapshot) {
+			log("Restart lighttpd to apply the new configuration");
+			trigger_restart();
+			return;
+		}
+
+		if (quota_changed || old.heartbeat_ms != _config.heartbeat_ms)
+			Managed_init::generate_config([&] (Generator &g) {
+				_update_init_config(g); });
+	}
+
+	/*
+	 * Restart lighttpd to take a fresh snapshot of the website
+	 */
+	void update_snapshot()
+	{
+		if (!_config.snapshot)
+			return;
+
+		_snapshots++;
+		_last_snapshot = from_rtc(_rtc.current_time());
+
+		_trigger_child_restart();
+		Managed_init::generate_config([&] (Generator &g) {
+			_update_init_config(g); });
+	}
+
+	/****************************
+	 ** Managed_init interface **
+	 ****************************/
+
+	void generate_report (Xml_generator &xml)           const override;
+	void generate_metrics(Metrics &)                    const override;
+	void state_update    (Init_state const &, bool)     override;
+};
+
+#endif /* _GENODIANS__LIGHTTPD_H_ */
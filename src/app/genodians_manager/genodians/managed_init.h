@@ -0,0 +1,244 @@
+/*
+ * \brief  Supervision of a sub init and its children
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__MANAGED_INIT_H_
+#define _GENODIANS__MANAGED_INIT_H_
+
+/* Genode includes */
+#include <base/attached_rom_dataspace.h>
+#include <os/reporter.h>
+
+/* local includes */
+#include <genodians/init_state.h>
+
+namespace Genodians {
+
+	/*
+	 * The Managed_init interface provides mechanisms for
+	 * monitoring and updating the managed init.
+	 */
+	struct Managed_init : Interface
+	{
+		Notify_interface &_state_change_notifier;
+
+		using Child_state_registery = Registry<Child_state>;
+		Child_state_registery child_states { };
+
+		/*
+		 * Registered child states by name
+		 *
+		 * The index is built once per report so that each '<child>' node
+		 * is matched with its child state in constant time instead of
+		 * consulting every registered child state. Its capacity is
+		 * independent from the number of children of an 'Init_state'.
+		 * Child states that do not fit into the index are found by
+		 * scanning the registry.
+		 */
+		struct Child_state_lookup
+		{
+			static constexpr unsigned CAPACITY = 32;
+
+			Child_state_registery &_registry;
+
+			Name_index<Start_name, Child_state *, CAPACITY> _index { };
+
+			bool _complete = true;
+
+			Child_state_lookup(Child_state_registery &registry)
+			:
+				_registry { registry }
+			{
+				_registry.for_each([&] (Child_state &child_state) {
+					if (!_index.insert(child_state.name(), &child_state))
+						_complete = false; });
+			}
+
+			void with_child_state(Start_name const &name, auto const &fn) const
+			{
+				_index.with_value(name, [&] (Child_state *child_state) {
+					fn(*child_state); },
+				[&] {
+					if (_complete)
+						return;
+
+					_registry.for_each([&] (Child_state &child_state) {
+						if (child_state.name() == name)
+							fn(child_state); }); });
+			}
+		};
+
+		Init_state _init_state { };
+
+		/*
+		 * Returns true if the state differs from the cached one
+		 */
+		bool _update_init_state(Init_state const &state)
+		{
+			if (!state.differs_from(_init_state))
+				return false;
+
+			_init_state = state;
+			return true;
+		}
+
+		Rom_handler<Managed_init> _state_rom;
+
+		void _state_update(Node const &node) { apply_state_report(node); }
+
+		Expanding_reporter _config_reporter;
+
+		Managed_init(Env &env, Notify_interface &notify,
+		             char const *state_name, char const *config_name)
+		:
+			_state_change_notifier { notify },
+			_state_rom             { env, state_name, *this,
+			                         &Managed_init::_state_update },
+			_config_reporter       { env, "config", config_name }
+		{ }
+
+		/*
+		 * Evaluate a state report of the managed init
+		 *
+		 * Besides the ROM handler, reports from any other source, e.g.,
+		 * recorded ones, can be fed to the state machine of the derived
+		 * class this way.
+		 */
+		void apply_state_report(Node const &node)
+		{
+			Child_state_lookup const lookup { child_states };
+
+			/* upgrade RAM and cap quota on demand */
+			bool reconfigure = false;
+
+			Init_state const state = Init_state::from_node(node,
+				[&] (Node const &child, Start_name const &name) {
+					lookup.with_child_state(name, [&] (Child_state &child_state) {
+						if (child_state.apply_child_state_report(child))
+							reconfigure = true; }); });
+
+			/* complain once instead of on each report */
+			if (state.num_dropped && !_init_state.num_dropped)
+				error("init state report lists ", state.num_children + state.num_dropped,
+				      " children, only ", unsigned(Init_state::MAX_CHILDREN),
+				      " are supervised");
+
+			if (Managed_init::_update_init_state(state))
+				_state_change_notifier.notify();
+
+			state_update(_init_state, reconfigure);
+		}
+
+		void generate_config(auto const &fn)
+		{
+			_config_reporter.generate([&] (Generator &g) {
+				fn(g); });
+		}
+
+		void with_init_state(auto const &avail_fn,
+		                     auto const &missing_fn) const
+		{
+			if (_init_state.valid)
+				avail_fn(_init_state);
+			else
+				missing_fn();
+		}
+
+		/****************************
+		 ** Managed_init interface **
+		 ****************************/
+
+		virtual void generate_report (Xml_generator &)          const = 0;
+		virtual void generate_metrics(Metrics &)                const = 0;
+		virtual void state_update    (Init_state const &, bool)       = 0;
+	};
+
+	/*
+	 * The Managed_child interface streamlines the generation
+	 * of the configuration for each step of the import process
+	 * and provides a convenience state checker.
+	 *
+	 */
+	struct Managed_child : Interface
+	{
+		struct Ok    { bool finished;   };
+		struct Error { int  exit_value; };
+
+		using Result = Attempt<Ok, Error>;
+
+		Child_state _child_state;
+
+		/* peak consumption as observed in the state reports of the init */
+		size_t        _peak_ram  = 0;
+		unsigned long _peak_caps = 0;
+
+		Managed_child(Managed_init::Child_state_registery &registry,
+		              char const *name, Priority priority,
+		              Ram_quota ram, Cap_quota caps)
+		:
+			_child_state { registry, name, priority, ram, caps }
+		{ }
+
+		virtual ~Managed_child() { }
+
+		Result check(Init_state const &state)
+		{
+			Child_progress progress = Child_progress::missing(state.num_dropped > 0);
+
+			state.with_child(name(), [&] (Init_state::Child const &child) {
+
+				Init_state::Resources const &res = child.resources;
+				if (res.ram_quota > res.ram_avail)
+					_peak_ram = max(_peak_ram, size_t(res.ram_quota - res.ram_avail));
+				if (res.caps_quota > res.caps_avail)
+					_peak_caps = max(_peak_caps, res.caps_quota - res.caps_avail);
+
+				progress = child.progress();
+
+				if (child.responsive() && child.exited && child.exit_code != 0)
+					error(name(), " exited with value ", child.exit_code);
+			}, [&] {
+				/* the child would never be seen finished */
+				if (state.num_dropped)
+					error(name(), " is not supervised, too many children");
+			});
+
+			using Verdict = Child_progress::Verdict;
+			switch (progress.verdict) {
+			case Verdict::PENDING:  return Ok { .finished = false };
+			case Verdict::FINISHED: return Ok { .finished = true };
+			case Verdict::FAILED:   break;
+			}
+			return Error { .exit_value = progress.exit_value };
+		}
+
+		void gen_start_node_content(Generator &g) const {
+			_child_state.gen_start_node_content(g); }
+
+		void trigger_restart() {
+			_child_state.trigger_restart(); }
+
+		Start_name const name() const {
+			return _child_state.name(); }
+
+		size_t        peak_ram()  const { return _peak_ram; }
+		unsigned long peak_caps() const { return _peak_caps; }
+
+		/*****************************
+		 ** Managed_child interface **
+		 *****************************/
+
+		virtual void  generate(Generator &g) const = 0;
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__MANAGED_INIT_H_ */
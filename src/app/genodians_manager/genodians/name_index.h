@@ -0,0 +1,91 @@
+/*
+ * \brief  Index of values by name
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__NAME_INDEX_H_
+#define _GENODIANS__NAME_INDEX_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+
+namespace Utils {
+
+	using Genode::uint8_t;
+	using Genode::uint32_t;
+
+	/*
+	 * Index of up to 'N' values by name
+	 *
+	 * The index is a hash table with open addressing over twice as many
+	 * slots as entries, which keeps the probe sequences short. Lookups
+	 * thereby take constant time on average regardless of the number of
+	 * entries.
+	 */
+	template <typename NAME, typename VALUE, unsigned N>
+	struct Name_index
+	{
+		static constexpr unsigned SLOTS = 2*N;
+
+		struct Slot
+		{
+			NAME  name  { };
+			VALUE value { };
+			bool  used  = false;
+		};
+
+		Slot     _slots[SLOTS] { };
+		unsigned _count = 0;
+
+		/* FNV-1a */
+		static unsigned _hash(NAME const &name)
+		{
+			uint32_t hash = 2166136261u;
+			for (char const *s = name.string(); *s; s++)
+				hash = (hash ^ uint8_t(*s)) * 16777619u;
+			return hash % SLOTS;
+		}
+
+		/*
+		 * Returns false if the index is full
+		 */
+		bool insert(NAME const &name, VALUE const &value)
+		{
+			if (_count == N)
+				return false;
+
+			unsigned i = _hash(name);
+			while (_slots[i].used && _slots[i].name != name)
+				i = (i + 1) % SLOTS;
+
+			if (!_slots[i].used)
+				_count++;
+
+			_slots[i] = { .name = name, .value = value, .used = true };
+			return true;
+		}
+
+		void with_value(NAME const &name, auto const &fn,
+		                                  auto const &missing_fn) const
+		{
+			for (unsigned i = _hash(name); _slots[i].used; i = (i + 1) % SLOTS)
+				if (_slots[i].name == name) {
+					fn(_slots[i].value);
+					return;
+				}
+			missing_fn();
+		}
+
+		unsigned count() const { return _count; }
+	};
+} /* namespace Utils */
+
+#endif /* _GENODIANS__NAME_INDEX_H_ */
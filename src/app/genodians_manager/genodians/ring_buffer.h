@@ -0,0 +1,61 @@
+/*
+ * \brief  Ring buffer of fixed capacity
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__RING_BUFFER_H_
+#define _GENODIANS__RING_BUFFER_H_
+
+namespace Utils {
+
+	/*
+	 * Ring buffer of fixed capacity, replacing the oldest entry when full
+	 */
+	template <typename T, unsigned N>
+	struct Ring_buffer
+	{
+		T        _entries[N] { };
+		unsigned _next  = 0;
+		unsigned _count = 0;
+
+		void add(T const &entry)
+		{
+			_entries[_next] = entry;
+			_next = (_next + 1) % N;
+			_count = _count < N ? _count + 1 : N;
+		}
+
+		/*
+		 * Call 'fn' for each entry starting with the oldest one
+		 */
+		void for_each(auto const &fn) const
+		{
+			for (unsigned i = 0; i < _count; i++)
+				fn(_entries[(_next + N - _count + i) % N]);
+		}
+
+		/*
+		 * Call 'fn' for each entry starting with the most recent one
+		 *
+		 * The iteration stops as soon as 'fn' returns false.
+		 */
+		void for_each_recent(auto const &fn) const
+		{
+			for (unsigned i = 0; i < _count; i++)
+				if (!fn(_entries[(_next + N - 1 - i) % N]))
+					return;
+		}
+
+		void clear() { _next = _count = 0; }
+	};
+} /* namespace Utils */
+
+#endif /* _GENODIANS__RING_BUFFER_H_ */
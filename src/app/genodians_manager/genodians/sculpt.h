@@ -0,0 +1,82 @@
+/*
+ * \brief  Helpers for generating init configurations
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__SCULPT_H_
+#define _GENODIANS__SCULPT_H_
+
+/* Genode includes */
+#include <cpu_session/cpu_session.h>
+#include <log_session/log_session.h>
+#include <pd_session/pd_session.h>
+#include <rm_session/rm_session.h>
+#include <rom_session/rom_session.h>
+
+/* sculpt_manager includes */
+#include <model/child_state.h>
+
+/*
+ * Extend helper utilities from Sculpt
+ */
+namespace Sculpt {
+	inline void gen_default_route_parent(Generator &g)
+	{
+		g.node("default-route", [&] {
+			g.node("any-service", [&] {
+				g.node("parent", [&] { }); }); });
+	}
+
+	inline void gen_common_parent_routes(Generator &g)
+	{
+		gen_service_node<Rom_session>(g, [&] { g.node("parent", [&] {}); });
+		gen_service_node<Cpu_session>(g, [&] { g.node("parent", [&] {}); });
+		gen_service_node<Pd_session> (g, [&] { g.node("parent", [&] {}); });
+		gen_service_node<Rm_session> (g, [&] { g.node("parent", [&] {}); });
+		gen_service_node<Log_session>(g, [&] { g.node("parent", [&] {}); });
+	}
+
+	void gen_arg(Generator &g, auto const &arg) {
+		g.node("arg", [&] { g.attribute("value", arg); }); }
+
+	void gen_named_dir(Generator &g, char const *name, auto const &fn)
+	{
+		g.node("dir", [&] {
+			g.attribute("name", name);
+			fn(g); });
+	}
+
+	inline void gen_symlink(Generator &g, char const *name, char const *target)
+	{
+		g.node("symlink", [&] {
+			g.attribute("name", name);
+			g.attribute("target", target); });
+	}
+
+	inline void gen_rom(Generator &g, char const *name)
+	{
+		g.node("rom", [&] {
+			g.attribute("name", name);
+			g.attribute("binary", "no"); });
+	}
+
+	inline void gen_heartbeat_node(Generator &g, unsigned rate_ms) {
+		g.node("heartbeat", [&] { g.attribute("rate_ms", rate_ms); }); }
+
+	void gen_inline(Generator &g, char const *name, auto const &fn)
+	{
+		g.node("inline", [&] {
+			g.attribute("name", name);
+			fn(g); });
+	}
+} /* namespace Sculpt */
+
+#endif /* _GENODIANS__SCULPT_H_ */
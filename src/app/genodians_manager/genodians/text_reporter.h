@@ -0,0 +1,82 @@
+/*
+ * \brief  Reporter of verbatim text with a growing buffer
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__TEXT_REPORTER_H_
+#define _GENODIANS__TEXT_REPORTER_H_
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <os/reporter.h>
+
+/* local includes */
+#include <genodians/types.h>
+
+namespace Genodians { struct Text_reporter; }
+
+
+/*
+ * Reporter for content that is not XML, e.g., metrics or JSON
+ *
+ * Like the 'Expanding_reporter' does for XML, the content is generated
+ * anew into a buffer of twice the size whenever it exceeds the current
+ * buffer. Hence, the report is never truncated.
+ */
+struct Genodians::Text_reporter
+{
+	using Name = String<64>;
+
+	Env &_env;
+
+	Name const _name, _label;
+
+	Constructible<Attached_ram_dataspace> _buffer   { };
+	Constructible<Reporter>               _reporter { };
+
+	void _construct(size_t const size)
+	{
+		_buffer.construct(_env.ram(), _env.rm(), size);
+		_reporter.construct(_env, _name.string(), _label.string(),
+		                    Reporter::Buffer_size { size });
+		_reporter->enabled(true);
+	}
+
+	Text_reporter(Env &env, Name const &name, Name const &label,
+	              size_t const initial_size)
+	:
+		_env { env }, _name { name }, _label { label }
+	{
+		_construct(initial_size);
+	}
+
+	/*
+	 * Report the text printed by 'fn' to the 'Output' argument
+	 */
+	void generate(auto const &fn)
+	{
+		for (;;) {
+			char * const dst = _buffer->local_addr<char>();
+
+			Text_buffer buffer { dst, _buffer->size() };
+			fn(static_cast<Output &>(buffer));
+
+			if (!buffer.exceeded()) {
+				_reporter->report(dst, buffer.length());
+				return;
+			}
+
+			_construct(2*_buffer->size());
+		}
+	}
+};
+
+#endif /* _GENODIANS__TEXT_REPORTER_H_ */
@@ -0,0 +1,161 @@
+/*
+ * \brief  Time series of the NIC-router traffic rates
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__TRAFFIC_RATES_H_
+#define _GENODIANS__TRAFFIC_RATES_H_
+
+/* local includes */
+#include <genodians/types.h>
+
+namespace Genodians {
+
+	/*
+	 * Time series of the traffic rates of the NIC-router domains
+	 *
+	 * The rate between two consecutive state reports is kept for the
+	 * last 15 minutes. For the last 24 hours, only the peak rate of
+	 * each minute is retained.
+	 */
+	struct Traffic_rates
+	{
+		/* bytes per second */
+		struct Rate
+		{
+			uint32_t rx, tx;
+
+			Rate max(Rate const &other) const {
+				return { Genode::max(rx, other.rx), Genode::max(tx, other.tx) }; }
+		};
+
+		struct Sample
+		{
+			uint64_t time_ms;
+			Rate     rate;
+		};
+
+		/* sufficient for 15 minutes at the report interval of 5 seconds */
+		static constexpr unsigned NUM_SAMPLES = 256;
+		static constexpr unsigned NUM_MINUTES = 24*60;
+		static constexpr unsigned MAX_DOMAINS = 8;
+
+		static constexpr uint64_t MINUTE_MS = 60'000;
+
+		using Domain_name = String<32>;
+
+		struct Domain
+		{
+			Domain_name name { };
+
+			bool     sampled = false;
+			uint64_t last_ms = 0, last_rx = 0, last_tx = 0;
+
+			Rate current { };
+
+			Ring_buffer<Sample, NUM_SAMPLES> samples { };
+			Ring_buffer<Rate,   NUM_MINUTES> minutes { };
+
+			uint64_t minute      = 0;
+			Rate     minute_peak { };
+
+			static uint32_t _rate(uint64_t bytes, uint64_t ms) {
+				return uint32_t(min(bytes*1000/ms, uint64_t(~0u))); }
+
+			void sample(uint64_t now_ms, uint64_t rx, uint64_t tx)
+			{
+				/* counters restart from zero if the NIC router is restarted */
+				bool const valid = sampled && now_ms > last_ms
+				                && rx >= last_rx && tx >= last_tx;
+				if (!sampled)
+					minute = now_ms / MINUTE_MS;
+
+				sampled = true;
+
+				if (valid) {
+					current = { _rate(rx - last_rx, now_ms - last_ms),
+					            _rate(tx - last_tx, now_ms - last_ms) };
+					samples.add({ now_ms, current });
+
+					/* complete the past minute, minutes without samples are idle */
+					uint64_t const now_minute = now_ms / MINUTE_MS;
+					if (now_minute != minute) {
+						minutes.add(minute_peak);
+						for (uint64_t m = minute + 1; m < now_minute
+						                           && m <= minute + NUM_MINUTES; m++)
+							minutes.add(Rate { });
+						minute      = now_minute;
+						minute_peak = { };
+					}
+					minute_peak = minute_peak.max(current);
+				}
+
+				last_ms = now_ms;
+				last_rx = rx;
+				last_tx = tx;
+			}
+
+			Rate peak(uint64_t now_ms, uint64_t window_ms) const
+			{
+				Rate result { };
+				samples.for_each_recent([&] (Sample const &sample) {
+					if (now_ms - sample.time_ms > window_ms)
+						return false;
+					result = result.max(sample.rate);
+					return true; });
+				return result;
+			}
+
+			Rate peak_24h() const
+			{
+				Rate result = minute_peak;
+				minutes.for_each_recent([&] (Rate const &rate) {
+					result = result.max(rate);
+					return true; });
+				return result;
+			}
+		};
+
+		Domain   _domains[MAX_DOMAINS] { };
+		unsigned _num_domains = 0;
+
+		void update(Node const &state, uint64_t now_ms)
+		{
+			state.for_each_sub_node("domain", [&] (Node const &node) {
+
+				Domain_name const name = node.attribute_value("name", Domain_name());
+
+				Domain *domain = nullptr;
+				for (unsigned i = 0; i < _num_domains; i++)
+					if (_domains[i].name == name)
+						domain = &_domains[i];
+
+				if (!domain) {
+					if (_num_domains == MAX_DOMAINS)
+						return;
+					domain = &_domains[_num_domains++];
+					domain->name = name;
+				}
+
+				domain->sample(now_ms, node.attribute_value("rx_bytes", 0ull),
+				                       node.attribute_value("tx_bytes", 0ull));
+			});
+		}
+
+		void for_each_domain(auto const &fn) const
+		{
+			for (unsigned i = 0; i < _num_domains; i++)
+				fn(_domains[i]);
+		}
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__TRAFFIC_RATES_H_ */
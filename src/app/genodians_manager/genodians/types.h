@@ -0,0 +1,32 @@
+/*
+ * \brief  Common types of the genodians manager
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__TYPES_H_
+#define _GENODIANS__TYPES_H_
+
+/* local includes */
+#include <genodians/sculpt.h>
+#include <genodians/utils.h>
+
+namespace Genodians {
+	using namespace Genode;
+	using namespace Sculpt;
+	using namespace Utils;
+
+	struct Notify_interface : Interface
+	{
+		virtual void notify() const = 0;
+	};
+} /* namespace Genodians */
+
+#endif /* _GENODIANS__TYPES_H_ */
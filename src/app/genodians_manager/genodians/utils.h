@@ -0,0 +1,220 @@
+/*
+ * \brief  Utilities of the genodians manager
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _GENODIANS__UTILS_H_
+#define _GENODIANS__UTILS_H_
+
+/* Genode includes */
+#include <rtc_session/rtc_session.h>
+#include <util/xml_generator.h>
+
+/* local includes */
+#include <genodians/civil_time.h>
+#include <genodians/histogram.h>
+#include <genodians/name_index.h>
+#include <genodians/ring_buffer.h>
+
+namespace Utils {
+	using namespace Genode;
+
+	struct Seconds {
+
+		uint64_t value;
+
+		void print(Output &out) const
+		{
+			unsigned const d  = unsigned(value / 86400);
+			unsigned const dr = unsigned(value % 86400);
+			unsigned const h  = unsigned(dr / 3600);
+			unsigned const m  = unsigned(dr / 60 % 60);
+			unsigned const s  = unsigned(dr % 60);
+
+			if (d) Genode::print(out, d, " day",    d > 1 ? "s " : " ");
+			if (h) Genode::print(out, h, " hour",   h > 1 ? "s " : " ");
+			if (m) Genode::print(out, m, " minute", m > 1 ? "s " : " ");
+			if (s) Genode::print(out, s, " second", s > 1 ? "s"  : "");
+
+			if (!(d||h||m||s)) Genode::print(out, "0 seconds");
+		}
+
+		static Seconds from_rtc(Rtc::Timestamp const &);
+
+		Seconds diff(Seconds const &other) const
+		{
+			return { other.value - value };
+		}
+	};
+
+	Rtc::Timestamp from_seconds(Seconds const&);
+
+	/*
+	 * Duration measured via the monotonic timer
+	 */
+	struct Duration_ms {
+
+		uint64_t value;
+
+		void print(Output &out) const
+		{
+			if (value >= 60'000) {
+				Genode::print(out, Seconds { value / 1000 });
+				return;
+			}
+
+			uint64_t const ms = value % 1000;
+			Genode::print(out, value / 1000, ".", ms < 100 ? "0" : "",
+			                                      ms <  10 ? "0" : "", ms, " seconds");
+		}
+
+		/* rounded up to full seconds */
+		Seconds seconds() const { return { (value + 999) / 1000 }; }
+	};
+
+	/*
+	 * Milliseconds printed as fractional seconds without trailing zeros,
+	 * e.g., for metrics given in the base unit
+	 */
+	struct Fractional_seconds {
+
+		uint64_t ms;
+
+		void print(Output &out) const
+		{
+			Genode::print(out, ms / 1000);
+
+			unsigned const frac = unsigned(ms % 1000);
+			if (!frac)
+				return;
+
+			char digits[4] = { char('0' + frac / 100), char('0' + frac / 10 % 10),
+			                   char('0' + frac % 10), 0 };
+			for (unsigned i = 2; digits[i] == '0'; i--)
+				digits[i] = 0;
+
+			Genode::print(out, ".", Cstring(digits));
+		}
+	};
+
+	using Date = String<21>;
+	inline Date from_rtc(Rtc::Timestamp const &ts)
+	{
+		bool const iso_8601 = true;
+
+		bool const pad_month  = ts.month  < 10;
+		bool const pad_day    = ts.day    < 10;
+		bool const pad_hour   = ts.hour   < 10;
+		bool const pad_minute = ts.minute < 10;
+		bool const pad_second = ts.second < 10;
+
+		return Date(ts.year, "-",
+		            pad_month  ? "0" : "", ts.month,  "-",
+		            pad_day    ? "0" : "", ts.day,    iso_8601 ? "T" : " ",
+		            pad_hour   ? "0" : "", ts.hour,   ":",
+		            pad_minute ? "0" : "", ts.minute, ":",
+		            pad_second ? "0" : "", ts.second, iso_8601 ? "Z" : "");
+	}
+
+	namespace Html {
+		using String = String<64>;
+		void gen_section_div(Xml_generator &xml, char const *name, auto const &fn);
+		void gen_table_body(Xml_generator &xml, auto const &fn);
+		void gen_table_key_value_row(Xml_generator &, Html::String const &, Html::String const &);
+		String rate_string(uint64_t bytes_per_sec);
+	} /* namespace Html */
+
+	/*
+	 * Output into a fixed-size buffer, excess characters are dropped
+	 */
+	struct Text_buffer : Output
+	{
+		char         *_dst;
+		size_t const  _capacity;
+		size_t        _length   = 0;
+		bool          _exceeded = false;
+
+		Text_buffer(char *dst, size_t capacity)
+		: _dst { dst }, _capacity { capacity } { }
+
+		void out_char(char c) override
+		{
+			if (_length < _capacity) _dst[_length++] = c;
+			else                     _exceeded = true;
+		}
+
+		size_t length()   const { return _length; }
+		bool   exceeded() const { return _exceeded; }
+	};
+
+	/*
+	 * Generator for metrics in the Prometheus text exposition format
+	 */
+	struct Metrics
+	{
+		Output &_out;
+
+		void family(char const *name, char const *type, char const *help)
+		{
+			print(_out, "# HELP ", name, " ", help, "\n");
+			print(_out, "# TYPE ", name, " ", type, "\n");
+		}
+
+		void sample(char const *name, auto const &value) {
+			print(_out, name, " ", value, "\n"); }
+
+		void sample(char const *name, char const *label,
+		            auto const &label_value, auto const &value) {
+			print(_out, name, "{", label, "=\"", label_value, "\"} ", value, "\n"); }
+
+		void sample(char const *name, char const *label_1, auto const &value_1,
+		                              char const *label_2, auto const &value_2,
+		                              auto const &value) {
+			print(_out, name, "{", label_1, "=\"", value_1, "\",",
+			                       label_2, "=\"", value_2, "\"} ", value, "\n"); }
+
+		/*
+		 * Histogram of durations in milliseconds, exported in seconds
+		 */
+		template <unsigned N>
+		void duration_histogram(char const *name, char const *label,
+		                        char const *label_value, Histogram<N> const &histogram)
+		{
+			auto bucket = [&] (auto const &le, uint64_t count) {
+				print(_out, name, "_bucket{", label, "=\"", label_value, "\",",
+				      "le=\"", le, "\"} ", count, "\n"); };
+
+			histogram.for_each_bucket([&] (uint64_t le_ms, uint64_t count) {
+				bucket(Fractional_seconds { le_ms }, count); });
+			bucket("+Inf", histogram.count());
+
+			print(_out, name, "_sum{",   label, "=\"", label_value, "\"} ",
+			      Fractional_seconds { histogram.sum() }, "\n");
+			print(_out, name, "_count{", label, "=\"", label_value, "\"} ",
+			      histogram.count(), "\n");
+		}
+	};
+} /* namespace Utils */
+
+
+void Utils::Html::gen_section_div(Xml_generator &xml, char const *name, auto const &fn)
+{
+	xml.node("div", [&] {
+		xml.attribute("id", name);
+		xml.node("h3", [&] { xml.append(name); });
+		fn(xml); });
+}
+
+
+void Utils::Html::gen_table_body(Xml_generator &xml, auto const &fn) {
+	xml.node("table", [&] { xml.node("tbody", [&] { fn(xml); }); }); }
+
+#endif /* _GENODIANS__UTILS_H_ */
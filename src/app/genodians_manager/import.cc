@@ -0,0 +1,428 @@
+/*
+ * \brief  Import of the content and generation of the website
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* local includes */
+#include <genodians/import.h>
+
+
+void Genodians::Import::generate_metrics(Metrics &metrics) const
+{
+	metrics.family("genodians_imports_total", "counter",
+	               "Number of completed imports");
+	metrics.sample("genodians_imports_total", _imports);
+
+	metrics.family("genodians_import_duration_seconds", "histogram",
+	               "Duration of complete imports");
+	metrics.duration_histogram("genodians_import_duration_seconds", "import", "all",
+	                           _import_durations);
+
+	metrics.family("genodians_import_step_duration_seconds", "histogram",
+	               "Duration of the successful import steps");
+	metrics.duration_histogram("genodians_import_step_duration_seconds", "step", "fetch",
+	                           _fetch_durations);
+	metrics.duration_histogram("genodians_import_step_duration_seconds", "step", "wipe",
+	                           _wipe_durations);
+	metrics.duration_histogram("genodians_import_step_duration_seconds", "step", "extract",
+	                           _extract_durations);
+	metrics.duration_histogram("genodians_import_step_duration_seconds", "step", "generate",
+	                           _generate_durations);
+
+	uint64_t const now_ms = _now_ms();
+
+	metrics.family("genodians_fetch_bytes", "gauge",
+	               "Size of the archive downloaded by the last fetch step");
+	_fetch_stats.for_each_archive([&] (Fetch_stats::Archive const &archive) {
+		metrics.sample("genodians_fetch_bytes", "author", archive.name,
+		               archive.bytes); });
+
+	metrics.family("genodians_fetch_duration_seconds", "gauge",
+	               "Download duration of the archive at the last fetch step");
+	_fetch_stats.for_each_archive([&] (Fetch_stats::Archive const &archive) {
+		metrics.sample("genodians_fetch_duration_seconds", "author", archive.name,
+		               Fractional_seconds { archive.duration(now_ms).value }); });
+
+	metrics.family("genodians_fetch_bytes_per_second", "gauge",
+	               "Download throughput of the archive at the last fetch step");
+	_fetch_stats.for_each_archive([&] (Fetch_stats::Archive const &archive) {
+		metrics.sample("genodians_fetch_bytes_per_second", "author", archive.name,
+		               archive.throughput(now_ms)); });
+}
+
+
+void Genodians::Import::generate_report(Xml_generator &xml) const
+{
+	Html::gen_section_div(xml, "Import", [&] (Xml_generator &xml) {
+		if (_imports) {
+			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+				Html::gen_table_key_value_row(xml, Html::String("Total imports"),
+				                                   _imports);
+				Html::gen_table_key_value_row(xml, Html::String("Import duration"),
+				                                   _import_duration);
+				Html::gen_table_key_value_row(xml, Html::String("Last import"),
+				                                   _last_update);
+				Html::gen_table_key_value_row(xml, Html::String("Next import"),
+				                                   _next_update);
+			});
+			xml.node("p", [&] { xml.append("Last durations"); });
+			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+				Html::gen_table_key_value_row(xml, Html::String("Fetch"),
+				                                   _last_fetch_duration);
+				Html::gen_table_key_value_row(xml, Html::String("Extract"),
+				                                   _last_extract_duration);
+				Html::gen_table_key_value_row(xml, Html::String("Wipe"),
+				                                   _last_wipe_duration);
+				Html::gen_table_key_value_row(xml, Html::String("Generate"),
+				                                   _last_generate_duration);
+			});
+		}
+
+		if (!_fetch_stats.empty())
+			_generate_fetch_report(xml);
+
+		Managed_init::with_init_state([&] (Init_state const &state) {
+
+			/* denote importing activity */
+			if (state.num_children)
+				xml.node("p", [&] {
+					if (!_imports) xml.append("initial ");
+					xml.append("import under way…"); });
+
+			state.generate_report(xml);
+		}, [&] { });
+	});
+}
+
+
+void Genodians::Import::_generate_fetch_report(Xml_generator &xml) const
+{
+	uint64_t const now_ms = _now_ms();
+
+	auto td_right = [&] (Xml_generator &xml, auto const &value) {
+		xml.node("td", [&] {
+			xml.attribute("style", "text-align:right");
+			xml.append_sanitized(Html::String(value).string()); });
+	};
+
+	xml.node("p", [&] {
+		xml.append("Downloads (");
+		xml.append_sanitized(Html::String(Number_of_bytes(_fetch_stats.total_bytes()),
+		                                  " in total, longest first)").string());
+	});
+
+	xml.node("table", [&] {
+		xml.node("thead", [&] {
+			xml.node("tr", [&] {
+				static char const * const titles[] = {
+					"Author", "Size", "Duration", "Throughput", "Result" };
+
+				for (char const *title : titles)
+					xml.node("td", [&] {
+						xml.attribute("style", "text-align:center");
+						xml.append(title); }); }); });
+
+		xml.node("tbody", [&] {
+			_fetch_stats.for_each_by_duration(now_ms, [&] (Fetch_stats::Archive const &archive) {
+				xml.node("tr", [&] {
+					xml.node("td", [&] {
+						xml.append_sanitized(archive.name.string()); });
+					td_right(xml, Number_of_bytes(archive.bytes));
+					td_right(xml, archive.duration(now_ms));
+					td_right(xml, Html::rate_string(archive.throughput(now_ms)));
+					td_right(xml, !archive.active  ? "pending"
+					            : !archive.finished ? "running"
+					            :  archive.failed   ? "failed" : "success");
+				}); }); });
+	});
+}
+
+
+void Genodians::Import::state_update(Init_state const &state,
+                                     bool              reconfigure_init)
+{
+	Seconds  const current_secs = Seconds::from_rtc(_rtc.current_time());
+	uint64_t const now_ms       = _now_ms();
+
+	bool const timeout = _step_timeout_triggered;
+	_step_timeout_triggered = false;
+
+	State new_state      = State::INVALID;
+	int   new_exit_value = -1;
+
+	/*
+	 * The following section evaluates the current state - even
+	 * when a timeout happend because that is also treated like
+	 * beginning the next step.
+	 */
+
+	switch (_state) {
+	case State::INVALID:
+	{
+		break;
+	}
+	case State::INIT:
+	{
+		_import_start_ms = now_ms;
+		_trace.begin_cycle(now_ms);
+		new_state = State::FETCH;
+		break;
+	}
+	case State::FETCH:
+	{
+		new_state = _fetch->check(state).convert<State>(
+			[&] (Managed_child::Ok ok) {
+				return ok.finished ? State::WIPE : State::FETCH;
+			},
+			[&] (Managed_child::Error err) {
+				new_exit_value = err.exit_value;
+				return State::INVALID;
+			});
+
+		if (new_state != State::FETCH) {
+			if (new_state != State::INVALID) {
+				_last_fetch_duration = { now_ms - _import_step_start_ms };
+				_fetch_durations.observe(_last_fetch_duration.value);
+				_log_step(*_fetch, _last_fetch_duration);
+				_fetch_stats.complete(now_ms);
+			}
+			_fetch.destruct();
+		}
+		break;
+	}
+	case State::WIPE:
+	{
+		new_state = _wipe->check(state).convert<State>(
+			[&] (Managed_child::Ok ok) {
+				return ok.finished ? State::EXTRACT : State::WIPE;
+			},
+			[&] (Managed_child::Error err) {
+				new_exit_value = err.exit_value;
+				return State::INVALID;
+			});
+
+		if (new_state != State::WIPE) {
+			if (new_state != State::INVALID) {
+				_last_wipe_duration = { now_ms - _import_step_start_ms };
+				_wipe_durations.observe(_last_wipe_duration.value);
+				_log_step(*_wipe, _last_wipe_duration);
+			}
+			_wipe.destruct();
+		}
+		break;
+	}
+	case State::EXTRACT:
+	{
+		new_state = _extract->check(state).convert<State>(
+			[&] (Managed_child::Ok ok) {
+				return ok.finished ? State::GENERATE : State::EXTRACT;
+			},
+			[&] (Managed_child::Error err) {
+				new_exit_value = err.exit_value;
+				return State::INVALID;
+			});
+
+		if (new_state != State::EXTRACT) {
+			if (new_state != State::INVALID) {
+				_last_extract_duration = { now_ms - _import_step_start_ms };
+				_extract_durations.observe(_last_extract_duration.value);
+				_log_step(*_extract, _last_extract_duration);
+			}
+			_extract.destruct();
+		}
+		break;
+	}
+	case State::GENERATE:
+	{
+		new_state = _generate->check(state).convert<State>(
+			[&] (Managed_child::Ok ok) {
+				return ok.finished ? State::SLEEP : State::GENERATE;
+			},
+			[&] (Managed_child::Error err) {
+				new_exit_value = err.exit_value;
+				return State::INVALID;
+			});
+
+		if (new_state != State::GENERATE) {
+			if (new_state != State::INVALID) {
+				_last_generate_duration = { now_ms - _import_step_start_ms };
+				_generate_durations.observe(_last_generate_duration.value);
+				_log_step(*_generate, _last_generate_duration);
+				_website_update_notifier.notify();
+			}
+			_generate.destruct();
+		}
+
+		break;
+	}
+	case State::SLEEP:
+	{
+		new_state = _sleep_timeout_triggered ? State::INIT
+		                                     : State::SLEEP;
+		_sleep_timeout_triggered = false;
+		break;
+	}
+	} /* switch */
+
+	if (_state != new_state && _step_name(_state))
+		_trace.record(new_state == State::INVALID ? Import_trace::Type::STEP_FAILED
+		                                          : Import_trace::Type::STEP_END,
+		              now_ms, _step_name(_state));
+
+	/* the step is still being processed without apparent problems  */
+	if (_state == new_state && !reconfigure_init && !timeout)
+		return;
+
+	/* apply quota update */
+	if (reconfigure_init) {
+		if (_step_name(_state))
+			_trace.record(Import_trace::Type::QUOTA_UPGRADE, now_ms,
+			              _step_name(_state));
+		_report_trace();
+
+		Managed_init::generate_config([&] (Generator &g) {
+			_update_init_config(g); });
+		return;
+	}
+
+	/*
+	 * Start next processing step or restart the current one in
+	 * case the step-timeout triggered.
+	 */
+
+	if (!timeout || _step_timeout.scheduled())
+		_step_timeout.discard();
+
+	_import_step_start_ms = now_ms;
+
+	if (char const *step = _step_name(new_state)) {
+		if (timeout) {
+			_trace.record(Import_trace::Type::TIMEOUT, now_ms, step);
+			_trace.record(Import_trace::Type::RESTART, now_ms, step);
+		} else {
+			_trace.record(Import_trace::Type::STEP_BEGIN, now_ms, step);
+		}
+	}
+
+	switch (new_state) {
+	case State::FETCH:
+	{
+		if (timeout) _fetch->trigger_restart();
+		else         _fetch.construct(Managed_init::child_states, _config.fetchurl);
+		_fetch_stats.reset(now_ms);
+		_step_timeout_secs = _calculate_timeout(_last_fetch_duration.seconds(),
+		                                        /*
+		                                         * Failed downloads take up to 10s, so make
+		                                         * room for the odd ones out to fail.
+		                                         */
+		                                        Seconds{.value = 60u});
+		break;
+	}
+	case State::WIPE:
+	{
+		if (timeout) _wipe->trigger_restart();
+		else         _wipe.construct(Managed_init::child_states, _config.wipe);
+		_step_timeout_secs = _calculate_timeout(_last_wipe_duration.seconds());
+		break;
+	}
+	case State::EXTRACT:
+	{
+		if (timeout) _extract->trigger_restart();
+		else         _extract.construct(Managed_init::child_states, _config.extract);
+		_step_timeout_secs = _calculate_timeout(_last_extract_duration.seconds());
+		break;
+	}
+	case State::GENERATE:
+	{
+		if (timeout) _generate->trigger_restart();
+		else         _generate.construct(Managed_init::child_states, _config.generate);
+		_step_timeout_secs = _calculate_timeout(_last_generate_duration.seconds());
+		break;
+	}
+	case State::SLEEP:
+	{
+		Microseconds const to_us =
+			Microseconds { Microseconds(60'000'000ul).value * _config.sleep_duration };
+		_sleep_timeout.schedule(to_us);
+		_step_timeout_secs = { 0 };
+		_sleep_start_ms    = now_ms;
+		_initial_sleep     = false;
+
+		++_imports;
+		Seconds const dur { .value = _config.sleep_duration * 60 };
+
+		_import_duration = { now_ms - _import_start_ms };
+		_trace.record(Import_trace::Type::CYCLE_END, now_ms, "import");
+		_import_durations.observe(_import_duration.value);
+
+		if (_config.log_cycles)
+			log("import cycle=", _imports, " duration_ms=", _import_duration.value);
+
+		_last_update = Utils::from_rtc(from_seconds(current_secs));
+		_next_update = Utils::from_rtc(from_seconds({ current_secs.value + dur.value }));
+		break;
+	}
+	default:
+		/* INIT and INVALID are of no concern at this point */
+		break;
+	} /* switch */
+
+	if (_step_timeout_secs.value) {
+		Microseconds const to_us =
+			Microseconds { Microseconds(1'000'000ul).value * _step_timeout_secs.value };
+		_step_timeout.schedule(to_us);
+	}
+
+	// TODO evaluate new_exit_value to handle different invalid states
+
+	_state = new_state;
+	Managed_init::generate_config([&] (Generator &g) {
+		_update_init_config(g); });
+
+	_report_trace();
+}
+
+
+void Genodians::Import::_update_init_config(Generator &g)
+{
+	g.attribute("verbose", "no");
+
+	g.node("report", [&] {
+		g.attribute("init_ram",   "yes");
+		g.attribute("init_caps",  "yes");
+		g.attribute("child_ram",  "yes");
+		g.attribute("child_caps", "yes");
+		g.attribute("delay_ms",   5000);
+		g.attribute("buffer",     "64K");
+	});
+
+	g.node("parent-provides", [&] {
+		gen_parent_service<Rom_session>(g);
+		gen_parent_service<Cpu_session>(g);
+		gen_parent_service<Pd_session>(g);
+		gen_parent_service<Rm_session>(g);
+		gen_parent_service<Log_session>(g);
+		gen_parent_service<Timer::Session>(g);
+		gen_parent_service<Rtc::Session>(g);
+		gen_parent_service<Nic::Session>(g);
+		gen_parent_service<File_system::Session>(g);
+		gen_parent_service<Report::Session>(g);
+	});
+
+	gen_heartbeat_node(g, _config.heartbeat_ms);
+
+	gen_default_route_parent(g);
+
+	if (_fetch.constructed())    _fetch->   generate(g);
+	if (_wipe.constructed())     _wipe->    generate(g);
+	if (_extract.constructed())  _extract-> generate(g);
+	if (_generate.constructed()) _generate->generate(g);
+}
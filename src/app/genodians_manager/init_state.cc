@@ -0,0 +1,67 @@
+/*
+ * \brief  Parsed subset of an init state report
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* local includes */
+#include <genodians/init_state.h>
+
+
+void Genodians::Init_state::generate_report(Xml_generator &xml) const
+{
+	using Cell = String<48>;
+
+	auto td = [&] (Xml_generator &xml, auto const &value) {
+		xml.node("td", [&] {
+			xml.attribute("style", "text-align:right");
+			xml.append_sanitized(Cell(value).string()); });
+	};
+
+	auto gen_row = [&] (Xml_generator &xml, auto const &name,
+	                    Resources const &res, auto const &heartbeats,
+	                    auto const &state) {
+		xml.node("tr", [&] {
+			xml.node("td", [&] { xml.append_sanitized(Cell(name).string()); });
+			td(xml, Cell((res.ram_quota - res.ram_avail) / 1024, " / ",
+			             res.ram_quota / 1024, " KiB"));
+			td(xml, Cell(res.caps_quota - res.caps_avail, " / ", res.caps_quota));
+			td(xml, heartbeats);
+			td(xml, state);
+		});
+	};
+
+	xml.node("table", [&] {
+		xml.node("thead", [&] {
+			xml.node("tr", [&] {
+				static char const * const titles[] = {
+					"Child", "RAM", "Caps", "Skipped heartbeats", "State" };
+
+				for (char const *title : titles)
+					xml.node("td", [&] {
+						xml.attribute("style", "text-align:center");
+						xml.append(title); }); }); });
+
+		xml.node("tbody", [&] {
+			gen_row(xml, "init", init, "", "");
+			for_each_child([&] (Child const &child) {
+				gen_row(xml, child.name, child.resources,
+				        child.skipped_heartbeats,
+				        child.exited ? Cell("exited (", child.exit_code, ")")
+				                     : Cell("running")); });
+			if (num_dropped)
+				xml.node("tr", [&] {
+					xml.node("td", [&] {
+						xml.attribute("colspan", 5);
+						xml.append_sanitized(Cell(num_dropped, " more children,"
+						                          " not supervised").string()); }); });
+		});
+	});
+}
@@ -0,0 +1,214 @@
+/*
+ * \brief  Supervision of the lighttpd web server
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* local includes */
+#include <genodians/lighttpd.h>
+
+
+void Genodians::Lighttpd::generate_metrics(Metrics &metrics) const
+{
+	metrics.family("genodians_lighttpd_restarts_total", "counter",
+	               "Number of lighttpd restarts");
+	metrics.sample("genodians_lighttpd_restarts_total", _restarts);
+
+	metrics.family("genodians_lighttpd_snapshots_total", "counter",
+	               "Number of website snapshots taken by lighttpd");
+	metrics.sample("genodians_lighttpd_snapshots_total", _snapshots);
+}
+
+
+void Genodians::Lighttpd::generate_report(Xml_generator &xml) const
+{
+	Html::gen_section_div(xml, "Lighttpd", [&] (Xml_generator &xml) {
+		Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+			Html::gen_table_key_value_row(xml, Html::String("Event handler"),
+			                                   _config.profile.event_handler);
+			Html::gen_table_key_value_row(xml, Html::String("Network backend"),
+			                                   _config.profile.network_backend);
+			Html::gen_table_key_value_row(xml, Html::String("Max fds"),
+			                                   Html::String(_config.profile.max_fds));
+			Html::gen_table_key_value_row(xml, Html::String("Total restarts"),
+			                                   Html::String(_restarts));
+			if (_restarts == 0)
+				return;
+
+			Html::gen_table_key_value_row(xml, Html::String("Last restart"),
+			                                   _last_restart);
+		});
+		if (_snapshots)
+			Html::gen_table_body(xml, [&] (Xml_generator &xml) {
+				Html::gen_table_key_value_row(xml, Html::String("Website snapshots"),
+				                                   Html::String(_snapshots));
+				Html::gen_table_key_value_row(xml, Html::String("Last snapshot"),
+				                                   _last_snapshot);
+			});
+		Managed_init::with_init_state([&] (Init_state const &state) {
+			state.generate_report(xml); }, [&] { });
+	});
+}
+
+
+void Genodians::Lighttpd::state_update(Init_state const &state,
+                                       bool              reconfigure_init)
+{
+	state.with_child("lighttpd", [&] (Init_state::Child const &child) {
+		reconfigure_init |= child.exited || !child.responsive(); }, [&] { });
+
+	if (!reconfigure_init)
+		return;
+
+	_restart();
+}
+
+
+void Genodians::Lighttpd::_update_init_config(Generator &g)
+{
+	g.attribute("verbose", "no");
+
+	g.node("report", [&] {
+		g.attribute("init_ram",   "yes");
+		g.attribute("init_caps",  "yes");
+		g.attribute("child_ram",  "yes");
+		g.attribute("child_caps", "yes");
+		g.attribute("delay_ms",   5000);
+		g.attribute("buffer",     "64K");
+	});
+
+	g.node("parent-provides", [&] {
+		gen_parent_service<Rom_session>(g);
+		gen_parent_service<Cpu_session>(g);
+		gen_parent_service<Pd_session>(g);
+		gen_parent_service<Rm_session>(g);
+		gen_parent_service<Log_session>(g);
+		gen_parent_service<Timer::Session>(g);
+		gen_parent_service<Rtc::Session>(g);
+		gen_parent_service<Nic::Session>(g);
+		gen_parent_service<File_system::Session>(g);
+	});
+
+	gen_heartbeat_node(g, _config.heartbeat_ms);
+
+	g.node("start", [&] {
+		_start.gen_content(g);
+
+		g.node("heartbeat", [&] { });
+
+		g.node("config", [&] {
+			g.attribute("ld_verbose", "yes");
+
+			gen_arg(g, "lighttpd");
+			gen_arg(g, "-f");
+			gen_arg(g, "/etc/lighttpd/lighttpd.conf");
+			gen_arg(g, "-D");
+
+			g.node("vfs", [&] {
+
+				gen_named_dir(g, "dev", [&] (Generator &g) {
+					g.node("log",  [&] { });
+					g.node("null", [&] { });
+					g.node("rtc",  [&] { });
+					g.node("jitterentropy", [&] { g.attribute("name", "random"); });
+
+					/* aggregated by the manager */
+					g.node("log", [&] {
+						g.attribute("name",  "access_log");
+						g.attribute("label", "access"); }); });
+
+				gen_named_dir(g, "socket", [&] (Generator &g) {
+					g.node("lxip", [&] { g.attribute("dhcp", "yes"); }); });
+
+				gen_named_dir(g, "etc", [&] (Generator &g) {
+					gen_named_dir(g, "lighttpd", [&] (Generator &g) {
+						gen_rom(g, "lighttpd.conf");
+						gen_rom(g, "upload-user.conf");
+
+						/* included by 'lighttpd.conf' */
+						gen_inline(g, "profile.conf", [&] (Generator &g) {
+							_config.profile.for_each_conf_line([&] (auto const &line) {
+								g.append_quoted(line.string());
+								g.append_quoted("\n"); }); });
+
+						/* included by 'lighttpd.conf', empty unless serving a snapshot */
+						gen_inline(g, "snapshot.conf", [&] (Generator &g) {
+							if (_config.snapshot)
+								g.append_quoted(
+									"$HTTP[\"url\"] =~ \"^/(genodians_manager/|feeds/|(rss|RSS)(\\.gz)?$)\" {\n"
+									"  server.document-root = \"/live\"\n"
+									"}\n"); });
+
+						g.node("fs", [&] { g.attribute("label", "cert"); }); }); });
+
+				gen_named_dir(g, "website", [&] (Generator &g) {
+					gen_named_dir(g, ".well-known", [&] (Generator &g) {
+						gen_symlink(g, "acme-challenge", "/upload/acme-challenge"); });
+					gen_symlink(g, "upload", "/upload");
+
+					if (_config.snapshot) g.node("ram", [&] { });
+					else                  g.node("fs",  [&] { g.attribute("label", "website"); }); });
+
+				if (_config.snapshot) {
+
+					/*
+					 * The status page and the feeds are served from the live
+					 * file system as selected by 'snapshot.conf'. The status
+					 * page is updated continuously. Feeds are polled using
+					 * conditional requests and their modification time stays
+					 * stable as long as their content does not change.
+					 */
+					gen_named_dir(g, "live", [&] (Generator &g) {
+						g.node("fs", [&] { g.attribute("label", "website"); }); });
+
+					/*
+					 * Copy the website into the RAM file system at startup.
+					 * The files of the site generator are kept in the content
+					 * file system and thereby not part of the copy.
+					 */
+					g.node("import", [&] {
+						gen_named_dir(g, "website", [&] (Generator &g) {
+							g.node("fs", [&] { g.attribute("label", "website"); }); }); });
+				}
+
+				gen_named_dir(g, "upload", [&] (Generator &g) {
+					gen_symlink(g, "cert", "/etc/lighttpd/public");
+					gen_named_dir(g, "acme-challenge", [] (Generator &g) {
+						g.node("ram"); }); });
+
+			});
+
+			g.node("libc", [&] {
+				g.attribute("stdin",  "/dev/null");
+				g.attribute("stdout", "/dev/log");
+				g.attribute("stderr", "/dev/log");
+				g.attribute("rtc",    "/dev/rtc");
+				g.attribute("socket", "/socket"); }); });
+
+		g.node("route", [&] {
+			gen_service_node<File_system::Session>(g, [&] {
+				g.attribute("label", "cert");
+				g.node("parent", [&] {
+					g.attribute("label", "cert"); }); });
+			gen_service_node<File_system::Session>(g, [&] {
+				g.attribute("label", "website");
+				g.node("parent", [&] {
+					g.attribute("label", "website"); }); });
+			gen_service_node<Nic::Session>(g, [&] {
+				g.node("parent", [&] { }); });
+			gen_parent_route<Cpu_session>   (g);
+			gen_parent_route<Log_session>   (g);
+			gen_parent_route<Pd_session>    (g);
+			gen_parent_route<Rom_session>   (g);
+			gen_parent_route<Rtc::Session>  (g);
+			gen_parent_route<Timer::Session>(g);
+		});
+	});
+}
@@ -0,0 +1,63 @@
+/*
+ * \brief  Utilities of the genodians manager
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* local includes */
+#include <genodians/utils.h>
+
+
+Utils::Seconds Utils::Seconds::from_rtc(Rtc::Timestamp const &rtc)
+{
+	Civil_time const time { .year = rtc.year, .month  = rtc.month,  .day    = rtc.day,
+	                        .hour = rtc.hour, .minute = rtc.minute, .second = rtc.second };
+
+	return Seconds { .value = time.seconds() };
+}
+
+
+Rtc::Timestamp Utils::from_seconds(Utils::Seconds const &seconds)
+{
+	if (seconds.value > Civil_time::MAX_SECONDS)
+		return Rtc::Timestamp();
+
+	Civil_time const time = Civil_time::from_seconds(seconds.value);
+
+	return Rtc::Timestamp {
+		.microsecond = 0,
+		.second = time.second,
+		.minute = time.minute,
+		.hour   = time.hour,
+		.day    = time.day,
+		.month  = time.month,
+		.year   = time.year,
+	};
+}
+
+
+void Utils::Html::gen_table_key_value_row(Xml_generator &xml, Utils::Html::String const &key,
+                                                              Utils::Html::String const &value)
+{
+	xml.node("tr", [&] {
+		xml.node("td", [&] { xml.append(key.string()); });
+		xml.node("td", [&] { xml.append(value.string()); });
+	});
+}
+
+
+Utils::Html::String Utils::Html::rate_string(uint64_t bytes_per_sec)
+{
+	if (bytes_per_sec < 10*1024)
+		return Html::String(bytes_per_sec, " B/s");
+	if (bytes_per_sec < 10*1024*1024)
+		return Html::String(bytes_per_sec / 1024, " KiB/s");
+	return Html::String(bytes_per_sec / (1024*1024), " MiB/s");
+}
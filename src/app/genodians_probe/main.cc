@@ -0,0 +1,271 @@
+/*
+ * \brief  Latency probe for the Genodians web server
+ * \author Josef Soentgen
+ * \date   2026-10-18
+ *
+ * The probe periodically requests a set of representative URLs and
+ * reports the outcome and latency of each request. The report is
+ * evaluated by the Genodians manager.
+ */
+
+/*
+ * Copyright (C) 2026 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_rom_dataspace.h>
+#include <libc/component.h>
+#include <os/reporter.h>
+#include <timer_session/connection.h>
+
+/* libc includes */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace Genodians_probe {
+	using namespace Genode;
+
+	struct Config;
+	struct Main;
+}
+
+
+struct Genodians_probe::Config
+{
+	using Address = String<16>;
+	using Path    = String<64>;
+
+	static constexpr unsigned MAX_TARGETS = 8;
+
+	Address  address     { };
+	unsigned port        = 80;
+	unsigned interval_ms = 10'000;
+	unsigned timeout_ms  = 5'000;
+
+	Path     targets[MAX_TARGETS] { };
+	unsigned num_targets = 0;
+
+	static Config from_node(Node const &node)
+	{
+		Config config { };
+
+		config.address     = node.attribute_value("address",     Address("127.0.0.1"));
+		config.port        = node.attribute_value("port",        80u);
+		config.interval_ms = node.attribute_value("interval_ms", 10'000u);
+		config.timeout_ms  = node.attribute_value("timeout_ms",  5'000u);
+
+		node.for_each_sub_node("target", [&] (Node const &target) {
+			if (config.num_targets == MAX_TARGETS) {
+				warning("ignore targets exceeding ", MAX_TARGETS);
+				return;
+			}
+			config.targets[config.num_targets++] =
+				target.attribute_value("path", Path("/"));
+		});
+
+		return config;
+	}
+};
+
+
+struct Genodians_probe::Main
+{
+	Env &_env;
+
+	Attached_rom_dataspace _config_rom { _env, "config" };
+
+	Config const _config = Config::from_node(_config_rom.node());
+
+	Timer::Connection _timer { _env };
+
+	Expanding_reporter _reporter { _env, "probe", "probe" };
+
+	using Error = String<16>;
+
+	struct Result
+	{
+		uint64_t latency_ms = 0;
+		unsigned status     = 0;
+		size_t   bytes      = 0;
+		Error    error      { };
+
+		/* a redirect still proves that the server is responsive */
+		bool success() const {
+			return !error.valid() && status >= 200 && status < 400; }
+	};
+
+	Result   _results[Config::MAX_TARGETS] { };
+	unsigned _round = 0;
+
+	uint64_t _now_ms() {
+		return _timer.curr_time().trunc_to_plain_ms().value; }
+
+	/*
+	 * Wait until 'fd' is ready for 'events', returns false on timeout
+	 */
+	bool _wait(int fd, short events, uint64_t deadline_ms)
+	{
+		for (;;) {
+			uint64_t const now_ms = _now_ms();
+			if (now_ms >= deadline_ms)
+				return false;
+
+			pollfd pfd { .fd = fd, .events = events, .revents = 0 };
+
+			int const ret = poll(&pfd, 1, int(deadline_ms - now_ms));
+			if (ret > 0)
+				return true;
+			if (ret == 0 || errno != EINTR)
+				return false;
+		}
+	}
+
+	Error _exchange(int fd, Config::Path const &path, uint64_t deadline_ms,
+	                Result &result)
+	{
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+
+		sockaddr_in addr { };
+		addr.sin_family = AF_INET;
+		addr.sin_port   = htons(uint16_t(_config.port));
+		if (inet_pton(AF_INET, _config.address.string(), &addr.sin_addr) != 1)
+			return "address";
+
+		if (connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS)
+			return "connect";
+
+		if (!_wait(fd, POLLOUT, deadline_ms))
+			return "timeout";
+
+		int       err = 0;
+		socklen_t len = sizeof(err);
+		if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err)
+			return "connect";
+
+		/* HTTP/1.0 lets the server close the connection after the response */
+		String<160> const request("GET ", path, " HTTP/1.0\r\n",
+		                          "Host: ", _config.address, "\r\n",
+		                          "User-Agent: genodians_probe\r\n\r\n");
+
+		char const *src  = request.string();
+		size_t      left = request.length() - 1;
+		while (left) {
+			if (!_wait(fd, POLLOUT, deadline_ms))
+				return "timeout";
+
+			ssize_t const n = send(fd, src, left, 0);
+			if (n < 0 && errno == EAGAIN)
+				continue;
+			if (n <= 0)
+				return "send";
+
+			src  += n;
+			left -= size_t(n);
+		}
+
+		/* read the whole response, only the status line is evaluated */
+		char   head[16] { };
+		size_t head_len = 0;
+		char   buf[1024];
+		for (;;) {
+			if (!_wait(fd, POLLIN, deadline_ms))
+				return "timeout";
+
+			ssize_t const n = recv(fd, buf, sizeof(buf), 0);
+			if (n < 0 && errno == EAGAIN)
+				continue;
+			if (n < 0)
+				return "recv";
+			if (n == 0)
+				break;
+
+			for (ssize_t i = 0; i < n && head_len < sizeof(head) - 1; i++)
+				head[head_len++] = buf[i];
+
+			result.bytes += size_t(n);
+		}
+
+		/* "HTTP/1.x NNN" */
+		if (head_len < 12 || Genode::strcmp(head, "HTTP/", 5) != 0)
+			return "response";
+
+		ascii_to(head + 9, result.status);
+		return Error();
+	}
+
+	Result _request(Config::Path const &path)
+	{
+		Result result { };
+
+		uint64_t const start_ms = _now_ms();
+
+		int const fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0) {
+			result.error = "socket";
+			return result;
+		}
+
+		result.error      = _exchange(fd, path, start_ms + _config.timeout_ms, result);
+		result.latency_ms = _now_ms() - start_ms;
+
+		close(fd);
+		return result;
+	}
+
+	void _probe_round()
+	{
+		_round++;
+
+		for (unsigned i = 0; i < _config.num_targets; i++)
+			_results[i] = _request(_config.targets[i]);
+
+		_reporter.generate([&] (Generator &g) {
+			g.attribute("round", _round);
+
+			for (unsigned i = 0; i < _config.num_targets; i++) {
+				Result const &result = _results[i];
+
+				g.node("target", [&] {
+					g.attribute("path",       _config.targets[i]);
+					g.attribute("result",     result.success() ? "success" : "failed");
+					g.attribute("latency_ms", result.latency_ms);
+					g.attribute("bytes",      result.bytes);
+					if (result.status)
+						g.attribute("status", result.status);
+					if (result.error.valid())
+						g.attribute("error",  result.error);
+				});
+			}
+		});
+	}
+
+	Signal_handler<Main> _timer_handler {
+		_env.ep(), *this, &Main::_handle_timer };
+
+	void _handle_timer() {
+		Libc::with_libc([&] { _probe_round(); }); }
+
+	Main(Env &env) : _env { env }
+	{
+		if (!_config.num_targets)
+			warning("no probe targets configured");
+
+		_timer.sigh(_timer_handler);
+		_timer.trigger_periodic(1'000ull * _config.interval_ms);
+	}
+};
+
+
+void Libc::Component::construct(Libc::Env &env)
+{
+	static Genodians_probe::Main main(env);
+}
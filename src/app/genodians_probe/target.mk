@@ -0,0 +1,3 @@
+TARGET := genodians_probe
+SRC_CC := main.cc
+LIBS   := base libc
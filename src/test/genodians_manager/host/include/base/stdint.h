@@ -0,0 +1,33 @@
+/*
+ * \brief  Genode integer types for building on the host
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ *
+ * Stands in for the header of the Genode base API, which depends on the
+ * platform-specific 'base/fixed_stdint.h'.
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BASE__STDINT_H_
+#define _INCLUDE__BASE__STDINT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Genode {
+	using ::int8_t;   using ::uint8_t;
+	using ::int16_t;  using ::uint16_t;
+	using ::int32_t;  using ::uint32_t;
+	using ::int64_t;  using ::uint64_t;
+
+	using size_t = std::size_t;
+	using addr_t = std::uintptr_t;
+}
+
+#endif /* _INCLUDE__BASE__STDINT_H_ */
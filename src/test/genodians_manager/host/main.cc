@@ -0,0 +1,305 @@
+/*
+ * \brief  Host test of the platform-independent parts of the genodians manager
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ *
+ * The test covers the date conversion, the containers, and the evaluation
+ * of child progress against the host's C library and reference
+ * implementations. The benchmarks compare the name index with the linear
+ * search it replaced. Their results are printed as 'bench' lines.
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* libc includes */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+/* local includes */
+#include <genodians/child_progress.h>
+#include <genodians/civil_time.h>
+#include <genodians/histogram.h>
+#include <genodians/name_index.h>
+#include <genodians/ring_buffer.h>
+
+namespace Test {
+	using namespace Utils;
+	using namespace Genodians;
+	using Genode::uint64_t;
+
+	struct Name;
+	struct Main;
+}
+
+
+/*
+ * Counterpart of the 'Start_name' used by the manager
+ */
+struct Test::Name
+{
+	std::string _s { };
+
+	char const *string() const { return _s.c_str(); }
+
+	bool operator == (Name const &other) const { return _s == other._s; }
+	bool operator != (Name const &other) const { return _s != other._s; }
+};
+
+
+struct Test::Main
+{
+	unsigned _failed = 0;
+
+	void _expect(char const *what, auto const &value, auto const &expected)
+	{
+		if (value == expected)
+			return;
+
+		std::printf("Error: %s: got %lld, expected %lld\n", what,
+		            (long long)value, (long long)expected);
+		_failed++;
+	}
+
+	static uint64_t _now_us()
+	{
+		using namespace std::chrono;
+		return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	static void _log_bench(char const *name, unsigned iterations, uint64_t duration_us)
+	{
+		std::printf("bench %s iterations=%u duration_us=%llu ns_per_iteration=%llu\n",
+		            name, iterations, (unsigned long long)duration_us,
+		            (unsigned long long)(1000 * duration_us / iterations));
+	}
+
+	void _test_dates()
+	{
+		struct Date_case { Civil_time time; uint64_t secs; };
+
+		static Date_case const cases[] = {
+			{ { 1970,  1,  1,  0,  0,  0 },           0 },
+			{ { 1999, 12, 31, 23, 59, 59 },   946684799 },
+			{ { 2000,  2, 29, 12,  0,  0 },   951825600 },
+			{ { 2025,  1,  2,  3,  4,  5 },  1735787045 },
+			{ { 2038,  1, 19,  3, 14,  8 },  2147483648 },
+			{ { 9999, 12, 31, 23, 59, 59 }, Civil_time::MAX_SECONDS } };
+
+		for (Date_case const &c : cases) {
+			Civil_time const t = Civil_time::from_seconds(c.secs);
+
+			_expect("seconds", c.time.seconds(), c.secs);
+			_expect("year",    t.year,   c.time.year);
+			_expect("month",   t.month,  c.time.month);
+			_expect("day",     t.day,    c.time.day);
+			_expect("hour",    t.hour,   c.time.hour);
+			_expect("minute",  t.minute, c.time.minute);
+			_expect("second",  t.second, c.time.second);
+		}
+
+		/* times about a day apart up to 9999-12-31 against the C library */
+		unsigned mismatches = 0;
+		for (uint64_t secs = 0; secs <= Civil_time::MAX_SECONDS; secs += 86400 + 3661) {
+
+			time_t const value = time_t(secs);
+			struct tm tm;
+			gmtime_r(&value, &tm);
+
+			Civil_time const t = Civil_time::from_seconds(secs);
+			if (t.year   != unsigned(tm.tm_year + 1900)
+			 || t.month  != unsigned(tm.tm_mon + 1)
+			 || t.day    != unsigned(tm.tm_mday)
+			 || t.hour   != unsigned(tm.tm_hour)
+			 || t.minute != unsigned(tm.tm_min)
+			 || t.second != unsigned(tm.tm_sec)
+			 || t.seconds() != secs)
+				mismatches++;
+		}
+		_expect("mismatches with gmtime_r", mismatches, 0u);
+	}
+
+	void _test_name_index()
+	{
+		Name_index<Name, unsigned, 8> index { };
+
+		for (unsigned i = 0; i < 4; i++)
+			_expect("insert", index.insert(Name { "child-" + std::to_string(i) }, i), true);
+
+		/* the value of an existing name is replaced */
+		_expect("update", index.insert(Name { "child-3" }, 33u), true);
+		_expect("count after update", index.count(), 4u);
+
+		for (unsigned i = 4; i < 8; i++)
+			_expect("insert", index.insert(Name { "child-" + std::to_string(i) }, i), true);
+
+		_expect("insert into full index", index.insert(Name { "child-8" }, 8u), false);
+		_expect("count", index.count(), 8u);
+
+		for (unsigned i = 0; i < 9; i++) {
+			unsigned value = ~0u;
+			index.with_value(Name { "child-" + std::to_string(i) },
+				[&] (unsigned v) { value = v; }, [&] { value = 100; });
+
+			_expect("with_value", value, i == 3 ? 33u : i == 8 ? 100u : i);
+		}
+	}
+
+	void _test_histogram()
+	{
+		static uint64_t const bounds[] = { 10, 100, 1000 };
+
+		Histogram<3> histogram { bounds };
+
+		for (uint64_t value : { 1, 10, 11, 100, 5000, 7 })
+			histogram.observe(value);
+
+		_expect("count", histogram.count(), uint64_t(6));
+		_expect("sum",   histogram.sum(),   uint64_t(5129));
+
+		static uint64_t const expected[] = { 3, 5, 5 };
+		unsigned i = 0;
+		histogram.for_each_bucket([&] (uint64_t le, uint64_t cumulative) {
+			_expect("bucket bound", le, bounds[i]);
+			_expect("bucket count", cumulative, expected[i]);
+			i++; });
+		_expect("buckets", i, 3u);
+	}
+
+	void _test_ring_buffer()
+	{
+		Ring_buffer<unsigned, 4> ring { };
+
+		auto sum_of_order = [&] {
+			unsigned order = 0;
+			ring.for_each([&] (unsigned v) { order = order*10 + v; });
+			return order; };
+
+		for (unsigned v = 1; v <= 3; v++)
+			ring.add(v);
+		_expect("partial", sum_of_order(), 123u);
+
+		for (unsigned v = 4; v <= 6; v++)
+			ring.add(v);
+		_expect("wrapped", sum_of_order(), 3456u);
+
+		unsigned recent = 0;
+		ring.for_each_recent([&] (unsigned v) {
+			recent = recent*10 + v;
+			return v > 5; });
+		_expect("for_each_recent", recent, 65u);
+
+		ring.clear();
+		_expect("cleared", sum_of_order(), 0u);
+	}
+
+	void _test_child_progress()
+	{
+		using Verdict = Child_progress::Verdict;
+
+		struct Case { Child_progress progress; Verdict verdict; int exit_value; };
+
+		Case const cases[] = {
+			{ Child_progress::listed(false, 0, 0), Verdict::PENDING,  0 },
+			{ Child_progress::listed(false, 0, 2), Verdict::PENDING,  0 },
+			{ Child_progress::listed(false, 0, 3), Verdict::FAILED,   Child_progress::UNRESPONSIVE },
+			{ Child_progress::listed(true,  3, 3), Verdict::FAILED,   Child_progress::UNRESPONSIVE },
+			{ Child_progress::listed(true,  3, 0), Verdict::FAILED,   3 },
+			{ Child_progress::listed(true,  0, 0), Verdict::FINISHED, 0 },
+			{ Child_progress::missing(false),      Verdict::PENDING,  0 },
+			{ Child_progress::missing(true),       Verdict::FAILED,   Child_progress::UNSUPERVISED } };
+
+		for (Case const &c : cases) {
+			_expect("verdict", int(c.progress.verdict), int(c.verdict));
+			if (c.verdict == Verdict::FAILED)
+				_expect("exit value", c.progress.exit_value, c.exit_value);
+		}
+	}
+
+	/*
+	 * Lookup of each of 'N' names, via the index and via a linear search
+	 */
+	template <unsigned N>
+	void _bench_name_index(unsigned iterations)
+	{
+		Name names[N];
+		Name_index<Name, unsigned, N> index { };
+
+		for (unsigned i = 0; i < N; i++) {
+			names[i] = Name { "child-" + std::to_string(i) };
+			index.insert(names[i], i);
+		}
+
+		unsigned volatile found = 0;
+
+		uint64_t start_us = _now_us();
+		for (unsigned it = 0; it < iterations; it++)
+			for (Name const &name : names)
+				index.with_value(name, [&] (unsigned v) { found = found + v; }, [] { });
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "name_index children=%u", N);
+		_log_bench(label, iterations, _now_us() - start_us);
+
+		start_us = _now_us();
+		for (unsigned it = 0; it < iterations; it++)
+			for (Name const &name : names)
+				for (unsigned i = 0; i < N; i++)
+					if (std::strcmp(names[i].string(), name.string()) == 0) {
+						found = found + i;
+						break;
+					}
+
+		std::snprintf(label, sizeof(label), "linear_search children=%u", N);
+		_log_bench(label, iterations, _now_us() - start_us);
+	}
+
+	void _bench_dates(unsigned iterations)
+	{
+		uint64_t volatile sum = 0;
+
+		uint64_t const start_us = _now_us();
+		for (unsigned i = 0; i < iterations; i++)
+			sum = sum + Civil_time::from_seconds(1735787045ull + i * 977).seconds();
+
+		_log_bench("civil_time", iterations, _now_us() - start_us);
+	}
+
+	Main(unsigned iterations)
+	{
+		_test_dates();
+		_test_name_index();
+		_test_histogram();
+		_test_ring_buffer();
+		_test_child_progress();
+
+		_bench_name_index<8>(iterations);
+		_bench_name_index<32>(iterations);
+		_bench_name_index<256>(iterations);
+		_bench_dates(iterations * 100);
+	}
+};
+
+
+int main(int argc, char **argv)
+{
+	unsigned const iterations = argc > 1 ? unsigned(std::atoi(argv[1])) : 10000;
+
+	Test::Main const main { iterations ? iterations : 1 };
+
+	if (main._failed) {
+		std::printf("Test failed, %u errors\n", main._failed);
+		return 1;
+	}
+
+	std::printf("Test succeeded\n");
+	return 0;
+}
@@ -0,0 +1,426 @@
+/*
+ * \brief  Test and micro benchmarks of the genodians manager
+ * \author Josef Soentgen
+ * \date   2025-01-02
+ *
+ * The test drives the components of the manager with the data given in its
+ * configuration instead of a live scenario. Recorded init state reports are
+ * fed to the import state machine via 'apply_state_report' and timeouts are
+ * mocked by calling the timeout handlers directly. See
+ * run/genodians_manager_test.run for the recorded data.
+ */
+
+/*
+ * Copyright (C) 2025 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/attached_rom_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+
+/* local includes */
+#include <genodians/import.h>
+
+namespace Test {
+	using namespace Genodians;
+
+	struct Notifier;
+	struct Bench_init;
+	struct Main;
+}
+
+
+struct Test::Notifier : Genodians::Notify_interface
+{
+	unsigned mutable count = 0;
+
+	void notify() const override { count++; }
+};
+
+
+/*
+ * Managed init that merely counts the evaluated state reports
+ */
+struct Test::Bench_init : Genodians::Managed_init
+{
+	unsigned updates = 0;
+
+	Bench_init(Env &env, Notify_interface &notify)
+	:
+		Managed_init { env, notify, "bench.state", "bench.config" }
+	{ }
+
+	/****************************
+	 ** Managed_init interface **
+	 ****************************/
+
+	void generate_report (Xml_generator &)          const override { }
+	void generate_metrics(Metrics &)                const override { }
+	void state_update    (Init_state const &, bool)       override { updates++; }
+};
+
+
+struct Test::Main
+{
+	Env &_env;
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	Timer::Connection _timer { _env };
+	Rtc::Connection   _rtc   { _env };
+
+	Attached_rom_dataspace _config_rom { _env, "config" };
+
+	Config const _config = _config_rom.node().with_sub_node("manager",
+		[&] (Node const &node) { return Config::update_from_node(node); },
+		[&]                    { return Config::update_from_node(Node()); });
+
+	Notifier _state_notifier          { };
+	Notifier _website_update_notifier { };
+
+	Import _import { _env, _state_notifier, _website_update_notifier,
+	                 _timer, _rtc, _config.import_config };
+
+	unsigned _failed = 0;
+
+	void _expect(auto const &what, auto const &value, auto const &expected)
+	{
+		if (value == expected)
+			return;
+
+		error(what, ": ", value, " (expected ", expected, ")");
+		_failed++;
+	}
+
+	uint64_t _now_us() { return _timer.curr_time().trunc_to_plain_us().value; }
+
+	using Text = String<64>;
+
+
+	/*******************
+	 ** Configuration **
+	 *******************/
+
+	void _test_config(Node const &defaults_node)
+	{
+		Config const defaults = Config::update_from_node(defaults_node);
+
+		_expect("default status_update_interval", defaults.status_update_interval, 60u);
+		_expect("default status_buffer_size", size_t(defaults.status_buffer_size),
+		                                      size_t(16u << 10));
+
+		Config::Lighttpd const &lighttpd = defaults.lighttpd_config;
+		_expect("default lighttpd ram",  lighttpd.lighttpd.ram.value,  size_t(48u << 20));
+		_expect("default lighttpd caps", lighttpd.lighttpd.caps.value, size_t(300));
+		_expect("default event_handler", lighttpd.profile.event_handler,
+		                                 Config::Lighttpd::Profile::Name("select"));
+		_expect("default max_fds",        lighttpd.profile.max_fds,     128u);
+		_expect("default failed_rounds",  lighttpd.probe.failed_rounds, 3u);
+		_expect("default snapshot",       lighttpd.snapshot,            false);
+
+		Config::Import const &import_defaults = defaults.import_config;
+		_expect("default update_interval_min", import_defaults.sleep_duration,     180u);
+		_expect("default initial_delay_min",   import_defaults.initial_delay,      0u);
+		_expect("default trace_cycles",        import_defaults.trace_cycles,       3u);
+		_expect("default generate ram",        import_defaults.generate.ram.value, size_t(48u << 20));
+
+		/* values of the '<manager>' node of the test configuration */
+		_expect("status_update_interval", _config.status_update_interval, 30u);
+		_expect("status_min_interval_ms", _config.status_min_interval_ms, 5000u);
+		_expect("status_buffer_size", size_t(_config.status_buffer_size),
+		                              size_t(64u << 10));
+
+		Config::Lighttpd const &configured = _config.lighttpd_config;
+		_expect("lighttpd ram",     configured.lighttpd.ram.value,  size_t(64u << 20));
+		_expect("lighttpd caps",    configured.lighttpd.caps.value, size_t(500));
+		_expect("heartbeat_ms",     configured.heartbeat_ms,        1000u);
+		_expect("max_fds",          configured.profile.max_fds,     256u);
+		_expect("max_keep_alive_requests",
+		        configured.profile.max_keep_alive_requests, 4u);
+		_expect("latency_p99_ms",   configured.probe.latency_p99_ms,  250u);
+		_expect("degraded_rounds",  configured.probe.degraded_rounds, 30u);
+		_expect("snapshot",         configured.snapshot,              true);
+
+		/* the request-size limit is given in KiB to lighttpd */
+		bool request_size_line = false;
+		configured.profile.for_each_conf_line([&] (auto const &line) {
+			if (line == "server.max-request-size = 8")
+				request_size_line = true; });
+		_expect("max-request-size statement", request_size_line, true);
+
+		Config::Import const &import_config = _config.import_config;
+		_expect("update_interval_min", import_config.sleep_duration, 60u);
+		_expect("initial_delay_min",   import_config.initial_delay,  5u);
+		_expect("import heartbeat_ms", import_config.heartbeat_ms,   2000u);
+		_expect("fetchurl ram",  import_config.fetchurl.ram.value,  size_t(32u << 20));
+		_expect("fetchurl caps", import_config.fetchurl.caps.value, size_t(200));
+		_expect("wipe ram",      import_config.wipe.ram.value,      size_t(48u << 20));
+	}
+
+
+	/*******************************
+	 ** Time and date conversions **
+	 *******************************/
+
+	void _test_dates()
+	{
+		struct Date_case { char const *date; uint64_t secs; };
+
+		static Date_case const cases[] = {
+			{ "1970-01-01T00:00:00Z",          0 },
+			{ "1999-12-31T23:59:59Z",  946684799 },
+			{ "2000-02-29T12:00:00Z",  951825600 },
+			{ "2025-01-02T03:04:05Z", 1735787045 },
+			{ "2038-01-19T03:14:08Z", 2147483648 } };
+
+		for (Date_case const &c : cases) {
+			Rtc::Timestamp const ts = from_seconds(Seconds { c.secs });
+
+			_expect(Text("from_seconds(", c.secs, ")"), Utils::from_rtc(ts), Date(c.date));
+			_expect(Text("Seconds::from_rtc(", c.date, ")"),
+			        Seconds::from_rtc(ts).value, c.secs);
+		}
+
+		Rtc::Timestamp const ts {
+			.microsecond = 0,
+			.second = 5, .minute = 4, .hour = 3,
+			.day    = 2, .month  = 1, .year = 2025 };
+
+		_expect("Seconds::from_rtc", Seconds::from_rtc(ts).value, uint64_t(1735787045));
+		_expect("Seconds::diff", Seconds { 100 }.diff(Seconds { 160 }).value, uint64_t(60));
+
+		_expect("Seconds", Text(Seconds { 0 }),     Text("0 seconds"));
+		_expect("Seconds", Text(Seconds { 7322 }),  Text("2 hours 2 minutes 2 seconds"));
+		_expect("Seconds", Text(Seconds { 90061 }), Text("1 day 1 hour 1 minute 1 second"));
+
+		_expect("Duration_ms", Text(Duration_ms { 1234 }),  Text("1.234 seconds"));
+		_expect("Duration_ms", Text(Duration_ms { 5 }),     Text("0.005 seconds"));
+		_expect("Duration_ms", Text(Duration_ms { 61000 }), Text("1 minute 1 second"));
+		_expect("Duration_ms::seconds", Duration_ms { 1001 }.seconds().value, uint64_t(2));
+
+		_expect("Fractional_seconds", Text(Fractional_seconds { 3000 }), Text("3"));
+		_expect("Fractional_seconds", Text(Fractional_seconds { 1500 }), Text("1.5"));
+		_expect("Fractional_seconds", Text(Fractional_seconds { 120 }),  Text("0.12"));
+		_expect("Fractional_seconds", Text(Fractional_seconds { 1 }),    Text("0.001"));
+	}
+
+
+	/*****************************
+	 ** Supervision of children **
+	 *****************************/
+
+	/*
+	 * Evaluate each '<state>' node with 'Managed_child::check'
+	 *
+	 * The 'expect' attribute denotes the result as "pending", "finished",
+	 * or "error <exit value>".
+	 */
+	void _test_check(Node const &check)
+	{
+		Managed_init::Child_state_registery registry { };
+
+		Fetch fetch { registry, Config::Child::from_node(Node()) };
+
+		using Result = String<16>;
+
+		check.for_each_sub_node("state", [&] (Node const &node) {
+
+			Result const result = fetch.check(Init_state::from_node(node)).convert<Result>(
+				[&] (Managed_child::Ok ok) {
+					return Result(ok.finished ? "finished" : "pending"); },
+				[&] (Managed_child::Error err) {
+					return Result("error ", err.exit_value); });
+
+			_expect("Managed_child::check", result,
+			        node.attribute_value("expect", Result()));
+
+			if (node.has_attribute("peak_ram"))
+				_expect("peak RAM", fetch.peak_ram(),
+				        size_t(node.attribute_value("peak_ram", Number_of_bytes(0))));
+		});
+	}
+
+
+	/**************************
+	 ** Import state machine **
+	 **************************/
+
+	static char const *_state_name(Import::State state)
+	{
+		switch (state) {
+		case Import::State::INVALID: return "invalid";
+		case Import::State::INIT:    return "init";
+		case Import::State::SLEEP:   return "sleep";
+		default:                     return Import::_step_name(state);
+		}
+	}
+
+	/*
+	 * Replay the recorded state reports and timeouts
+	 *
+	 * Each '<state>' node is applied as init state report, '<sleep_timeout>'
+	 * and '<step_timeout>' trigger the respective timeout. The resulting
+	 * import state is compared with the 'expect' attribute, the number of
+	 * completed imports and website updates with the optional 'imports'
+	 * and 'website_updates' attributes.
+	 */
+	void _test_recording(Node const &recording)
+	{
+		using Name = String<16>;
+
+		Duration const now { Microseconds { _now_us() } };
+
+		/* the initial delay keeps the import from starting on its own */
+		_expect("initial state", Name(_state_name(_import._state)), Name("sleep"));
+
+		unsigned step = 0;
+		recording.for_each_sub_node([&] (Node const &node) {
+
+			step++;
+
+			if (node.has_type("state"))         _import.apply_state_report(node);
+			if (node.has_type("sleep_timeout")) _import._handle_sleep_timeout(now);
+			if (node.has_type("step_timeout"))  _import._handle_step_timeout(now);
+
+			_expect(Text("state after step ", step, " (", node.type(), ")"),
+			        Name(_state_name(_import._state)),
+			        node.attribute_value("expect", Name()));
+
+			if (node.has_attribute("imports"))
+				_expect(Text("imports after step ", step), _import._imports,
+				        node.attribute_value("imports", 0u));
+
+			if (node.has_attribute("website_updates"))
+				_expect(Text("website updates after step ", step),
+				        _website_update_notifier.count,
+				        node.attribute_value("website_updates", 0u));
+		});
+
+		if (_import._imports)
+			_expect("date of the last update", _import._last_update.valid(), true);
+	}
+
+
+	/**********************
+	 ** Micro benchmarks **
+	 **********************/
+
+	void _log_bench(auto const &name, unsigned iterations, uint64_t duration_us)
+	{
+		log("bench ", name, " iterations=", iterations,
+		    " duration_us=", duration_us,
+		    " per_iteration_ns=", duration_us*1000 / max(iterations, 1u));
+	}
+
+	/*
+	 * Evaluate an init state report with a growing number of registered
+	 * child states, the last of which exceeds the capacity of the name index
+	 */
+	void _bench_state_evaluation(Node const &state, unsigned iterations)
+	{
+		for (unsigned const registered : { 8u, 32u, 256u }) {
+
+			Bench_init init { _env, _state_notifier };
+
+			for (unsigned i = 0; i < registered; i++)
+				new (_heap) Child_state(init.child_states, Start_name("child-", i),
+				                        Priority { 0 }, Ram_quota { 1u << 20 },
+				                        Cap_quota { 100 });
+
+			init.updates = 0;
+
+			uint64_t const start_us = _now_us();
+			for (unsigned i = 0; i < iterations; i++)
+				init.apply_state_report(state);
+
+			_log_bench(Text("state_evaluation registered=", registered),
+			           iterations, _now_us() - start_us);
+
+			_expect("evaluated state reports", init.updates, iterations);
+
+			init.child_states.for_each([&] (Child_state &child_state) {
+				destroy(_heap, &child_state); });
+		}
+	}
+
+	/*
+	 * Generate the status and metrics of the import with the maximum
+	 * number of children and archives
+	 */
+	void _bench_report(Node const &bench, unsigned iterations)
+	{
+		bench.with_optional_sub_node("progress", [&] (Node const &progress) {
+			uint64_t const now_ms = _now_us() / 1000;
+			_import._fetch_stats.reset(now_ms);
+			_import._fetch_stats.update(progress, now_ms,
+				[&] (Fetch_stats::Url const &url) {
+					return _import._archive_name(url); }); });
+
+		bench.with_optional_sub_node("state", [&] (Node const &state) {
+			_import.apply_state_report(state); });
+
+		Expanding_reporter html_reporter { _env, "html", "bench.html" };
+
+		uint64_t start_us = _now_us();
+		for (unsigned i = 0; i < iterations; i++)
+			html_reporter.generate_xml([&] (Xml_generator &xml) {
+				_import.generate_report(xml); });
+
+		_log_bench("html_report", iterations, _now_us() - start_us);
+
+		Text_reporter metrics_reporter { _env, "metrics", "bench_metrics", 4u << 10 };
+
+		start_us = _now_us();
+		for (unsigned i = 0; i < iterations; i++)
+			metrics_reporter.generate([&] (Output &out) {
+				Metrics metrics { out };
+				_import.generate_metrics(metrics); });
+
+		_log_bench("metrics", iterations, _now_us() - start_us);
+	}
+
+	Main(Env &env) : _env { env }
+	{
+		Node const &config = _config_rom.node();
+
+		config.with_optional_sub_node("defaults", [&] (Node const &node) {
+			_test_config(node); });
+
+		_test_dates();
+
+		config.with_optional_sub_node("check", [&] (Node const &node) {
+			_test_check(node); });
+
+		config.with_optional_sub_node("recording", [&] (Node const &node) {
+			_test_recording(node); });
+
+		config.with_optional_sub_node("bench", [&] (Node const &bench) {
+
+			unsigned const iterations = bench.attribute_value("iterations", 1000u);
+
+			bench.with_optional_sub_node("state", [&] (Node const &state) {
+				_bench_state_evaluation(state, iterations); });
+
+			_bench_report(bench, iterations);
+		});
+
+		if (_failed) {
+			error(_failed, " checks failed");
+			_env.parent().exit(1);
+			return;
+		}
+
+		log("Test succeeded.");
+		_env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Genode::Env &env)
+{
+	static Test::Main main(env);
+}
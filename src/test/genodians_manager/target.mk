@@ -0,0 +1,14 @@
+TARGET := test-genodians_manager
+SRC_CC := main.cc utils.cc init_state.cc import.cc
+LIBS   := base
+
+# sources of the manager under test
+GENODIANS_MANAGER_DIR := $(call select_from_repositories,src/app/genodians_manager)
+INC_DIR += $(GENODIANS_MANAGER_DIR)
+
+vpath utils.cc      $(GENODIANS_MANAGER_DIR)
+vpath init_state.cc $(GENODIANS_MANAGER_DIR)
+vpath import.cc     $(GENODIANS_MANAGER_DIR)
+
+SCULPT_MANAGER__DIR := $(call select_from_repositories,src/app/sculpt_manager)
+INC_DIR += $(SCULPT_MANAGER__DIR)
@@ -0,0 +1,82 @@
+#
+# Summary of the build-time log recorded via tool/timed_shell
+#
+# Usage: tclsh tool/build_timing.tcl <log> <output> [<top-n>]
+#
+# The times of all recipe lines of a target are accumulated. The output is
+# an XML report with the total time per class of targets and the <top-n>
+# slowest targets (default 10), to be displayed by the genodians manager.
+#
+
+proc usage { } {
+	puts stderr "usage: build_timing.tcl <log> <output> \[<top-n>\]"
+	exit 1
+}
+
+if {[llength $argv] < 2 || [llength $argv] > 3} { usage }
+
+lassign $argv log_path output top_n
+if {$top_n eq ""} { set top_n 10 }
+
+proc target_class { target } {
+	switch -regexp -- $target {
+		{\.gz$}                                   { return gzip    }
+		{\.(png|css|ico)$}                        { return copy    }
+		{^html/summary/}                          { return summary }
+		{^html/(rss|RSS|feeds/.*)$}               { return rss     }
+		{^html/(index|archive.*|topics.*)$}       { return index   }
+		{^html/[^/]+/index$}                      { return index   }
+		{^html/[^/]+/author$}                     { return author  }
+		{^html/[^/]+/[0-9]{4}-[0-9]{2}-[0-9]{2}-} { return posting }
+		default                                   { return other   }
+	}
+}
+
+proc xml_escape { text } {
+	return [string map { & &amp; < &lt; > &gt; \" &quot; } $text]
+}
+
+# accumulate milliseconds per target
+set times [dict create]
+if {[file exists $log_path]} {
+	set fh [open $log_path]
+	foreach line [split [read $fh] "\n"] {
+		if {[llength $line] != 2} { continue }
+		lassign $line target seconds
+		if {![string is double -strict $seconds]} { continue }
+		dict incr times $target [expr {round($seconds*1000)}]
+	}
+	close $fh
+}
+
+set total_ms 0
+set classes [dict create]
+dict for {target ms} $times {
+	set class [target_class $target]
+	dict update classes $class entry {
+		lassign [expr {[info exists entry] ? $entry : {0 0}}] class_ms count
+		set entry [list [expr {$class_ms + $ms}] [expr {$count + 1}]]
+	}
+	incr total_ms $ms
+}
+
+set xml "<build_timing total_ms=\"$total_ms\" targets=\"[dict size $times]\">\n"
+
+foreach class [lsort [dict keys $classes]] {
+	lassign [dict get $classes $class] ms count
+	append xml "\t<class name=\"$class\" ms=\"$ms\" targets=\"$count\"/>\n"
+}
+
+set sorted [lsort -integer -decreasing -stride 2 -index 1 $times]
+foreach {target ms} [lrange $sorted 0 [expr {2*$top_n - 1}]] {
+	append xml "\t<target name=\"[xml_escape $target]\"" \
+	           " class=\"[target_class $target]\" ms=\"$ms\"/>\n"
+}
+
+append xml "</build_timing>\n"
+
+# replace the report at once, it may be observed by the manager at any time
+set fh [open $output.new "WRONLY CREAT TRUNC"]
+puts -nonewline $fh $xml
+close $fh
+file rename -force $output.new $output
@@ -0,0 +1,174 @@
+#
+# Scaling benchmark of the static site generator
+#
+# Usage: tclsh tool/corpus_scaling.tcl [<option> <value> ...] <work-dir>
+#
+# For each scale factor, a synthetic corpus with <authors> x <scale> authors
+# is generated by tool/synthetic_corpus.tcl in <work-dir>/scale-<scale>/
+# along with a copy of the generator. The website is then built twice, first
+# as dry run ('make -n'), which covers the evaluation of the Makefile, and
+# second for real with BUILD_TIMING=yes. For both, the wall-clock time and
+# the peak resident memory of the largest process (via GNU time if
+# installed) are measured. The result is printed as table, normalized per
+# posting so that super-linear behaviour stands out, and optionally written
+# as XML report including the time per class of targets.
+#
+# Options (defaults in parentheses):
+#
+#   -scales <list>        scale factors ("1 10 100")
+#   -authors <n>          number of authors at scale 1 (20)
+#   -jobs <n>             parallel make jobs (1)
+#   -corpus-args <list>   further options of synthetic_corpus.tcl ("")
+#   -output <file>        XML report ("")
+#
+
+proc usage { } {
+	puts stderr "usage: corpus_scaling.tcl \[<option> <value> ...\] <work-dir>"
+	exit 1
+}
+
+array set opt {
+	-scales      "1 10 100"
+	-authors     20
+	-jobs        1
+	-corpus-args ""
+	-output      ""
+}
+
+if {[llength $argv] % 2 != 1} { usage }
+
+foreach {key value} [lrange $argv 0 end-1] {
+	if {![info exists opt($key)]} { usage }
+	set opt($key) $value
+}
+set work_dir [file normalize [lindex $argv end]]
+set repo_dir [file normalize [file join [file dirname [info script]] ..]]
+
+if {![file exists $repo_dir/tool/gosh/gosh]} {
+	puts stderr "tool/gosh/gosh missing, please fetch the gosh submodule"
+	exit 1
+}
+
+set gnu_time [expr {[file executable /usr/bin/time] ? "/usr/bin/time" : ""}]
+if {$gnu_time eq ""} {
+	puts stderr "GNU time not installed at /usr/bin/time, peak memory not measured" }
+
+#
+# Execute make with the given arguments in $dir
+#
+# Returns a list of the elapsed seconds and the peak resident memory in KiB
+# of the largest process, or an empty string if unknown.
+#
+proc measured_make { dir args } {
+	global gnu_time
+
+	set stats_file $dir/.make_stats
+	set cmd [list make -C $dir {*}$args > /dev/null 2>@ stderr]
+	if {$gnu_time ne ""} {
+		set cmd [list $gnu_time -o $stats_file -f "%M" {*}$cmd] }
+
+	set start_ms [clock milliseconds]
+	if {[catch { exec {*}$cmd } err]} {
+		puts stderr "make $args failed in $dir: $err" }
+	set seconds [expr {([clock milliseconds] - $start_ms)/1000.0}]
+
+	set peak_kib ""
+	if {$gnu_time ne "" && [file exists $stats_file]} {
+		set fh [open $stats_file]
+		set peak_kib [lindex [split [string trim [read $fh]] "\n"] end]
+		close $fh
+	}
+	return [list $seconds $peak_kib]
+}
+
+proc dir_bytes { dir } {
+	set bytes 0
+	foreach path [glob -nocomplain -directory $dir * .*] {
+		if {[file tail $path] in {. ..}} { continue }
+		file lstat $path stat
+		switch $stat(type) {
+			directory { incr bytes [dir_bytes $path] }
+			file      { incr bytes $stat(size) }
+		}
+	}
+	return $bytes
+}
+
+proc per_posting { value postings } {
+	if {$value eq "" || $postings == 0} { return "-" }
+	return [format "%.2f" [expr {1000.0*$value/$postings}]]
+}
+
+set results {}
+
+foreach scale $opt(-scales) {
+
+	set dir     $work_dir/scale-$scale
+	set authors [expr {$opt(-authors) * $scale}]
+
+	puts "scale $scale: generating corpus of $authors authors"
+
+	file delete -force $dir
+	file mkdir $dir
+	foreach path { Makefile style tool } {
+		file copy $repo_dir/$path $dir/$path }
+
+	exec tclsh $repo_dir/tool/synthetic_corpus.tcl -authors $authors \
+	           {*}$opt(-corpus-args) $dir
+
+	set postings [llength [glob -nocomplain $dir/content/*/\[0-9\]*-*-*-*.txt]]
+
+	puts "scale $scale: evaluating Makefile for $postings postings"
+	lassign [measured_make $dir -n default] parse_s parse_kib
+
+	puts "scale $scale: building website"
+	lassign [measured_make $dir -k -j$opt(-jobs) default build_timing BUILD_TIMING=yes] \
+	        build_s build_kib
+
+	set classes {}
+	if {![catch { open $dir/content/.generate/timing.xml } fh]} {
+		foreach {_ name ms} [regexp -all -inline \
+		                     {<class name="([^"]+)" ms="([0-9]+)"} [read $fh]] {
+			lappend classes $name $ms }
+		close $fh
+	}
+
+	lappend results [dict create scale $scale authors $authors postings $postings \
+	                             parse_s $parse_s parse_kib $parse_kib \
+	                             build_s $build_s build_kib $build_kib \
+	                             html_bytes [dir_bytes $dir/html] classes $classes]
+}
+
+set format "%6s %8s %9s %9s %11s %9s %11s %13s %13s"
+puts ""
+puts [format $format scale authors postings parse_s parse_kib build_s build_kib \
+                     parse_ms/post build_ms/post]
+foreach r $results {
+	dict with r {
+		puts [format $format $scale $authors $postings $parse_s \
+		                     [expr {$parse_kib eq "" ? "-" : $parse_kib}] $build_s \
+		                     [expr {$build_kib eq "" ? "-" : $build_kib}] \
+		                     [per_posting $parse_s $postings] \
+		                     [per_posting $build_s $postings]]
+	}
+}
+
+if {$opt(-output) ne ""} {
+	set xml "<corpus_scaling jobs=\"$opt(-jobs)\">\n"
+	foreach r $results {
+		dict with r {
+			append xml "\t<scale factor=\"$scale\" authors=\"$authors\"" \
+			           " postings=\"$postings\" parse_s=\"$parse_s\"" \
+			           " parse_peak_kib=\"$parse_kib\" build_s=\"$build_s\"" \
+			           " build_peak_kib=\"$build_kib\" html_bytes=\"$html_bytes\">\n"
+			foreach {name ms} $classes {
+				append xml "\t\t<class name=\"$name\" ms=\"$ms\"/>\n" }
+			append xml "\t</scale>\n"
+		}
+	}
+	append xml "</corpus_scaling>\n"
+
+	set fh [open $opt(-output) "WRONLY CREAT TRUNC"]
+	puts -nonewline $fh $xml
+	close $fh
+}
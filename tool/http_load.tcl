@@ -0,0 +1,454 @@
+#
+# HTTP load generator for the genodians web server
+#
+# Usage: tclsh tool/http_load.tcl workload <html-dir> <output> [<option> <value> ...]
+#        tclsh tool/http_load.tcl run <host> <port> <workload> [<option> <value> ...]
+#
+# The 'workload' command samples requests from a generated website and
+# writes them to a workload file, one request per line in the form
+# '<class> <path> [gzip]'. The classes are 'index' (landing, archive, topic,
+# and author pages), 'posting', 'rss' (site and topic feeds), and 'asset'
+# (style sheets and images). With 'gzip', the request accepts gzip encoding.
+#
+#   -requests <n>    number of requests (1000)
+#   -mix <list>      weights of the classes
+#                    ("index 20 posting 45 rss 10 asset 25")
+#   -gzip <percent>  share of requests accepting gzip encoding (80)
+#   -seed <n>        seed of the random-number generator (1)
+#
+# The 'run' command replays the requests of the workload file in order
+# using a number of concurrent clients. Each client uses persistent HTTP/1.1
+# connections and opens a new connection whenever the server closes it. The
+# latency of a request is measured from issuing the request, or opening the
+# connection if needed, until the response is received completely. Requests
+# failing to connect, timing out, closed prematurely, or answered with a
+# status of 400 or above count as errors.
+#
+#   -connections <n>  number of concurrent clients (8)
+#   -repeat <n>       number of passes over the workload (1)
+#   -timeout <ms>     timeout of a single request (10000)
+#   -wait <s>         wait up to <s> seconds for the server to respond (0)
+#   -output <file>    XML report ("")
+#
+
+proc usage { } {
+	puts stderr "usage: http_load.tcl workload <html-dir> <output> \[<option> <value> ...\]"
+	puts stderr "       http_load.tcl run <host> <port> <workload> \[<option> <value> ...\]"
+	exit 1
+}
+
+proc parse_options { defaults args } {
+	array set opt $defaults
+	if {[llength $args] % 2} { usage }
+	foreach {key value} $args {
+		if {![info exists opt($key)]} { usage }
+		set opt($key) $value
+	}
+	return [array get opt]
+}
+
+
+##
+# Workload generation
+##
+
+proc site_paths { html_dir } {
+	set paths [dict create index {} posting {} rss {} asset {}]
+
+	foreach path [glob -nocomplain -directory $html_dir -tails *] {
+		switch -regexp -- $path {
+			{^index$}                             { dict lappend paths index / }
+			{^(archive(-[0-9]+)?|topics-[^.]+)$}  { dict lappend paths index /$path }
+			{^rss$}                               { dict lappend paths rss /rss }
+			{^[^.]+\.[0-9a-f]{8}\.(css|ico|png)$} { dict lappend paths asset /$path }
+		}
+	}
+
+	foreach path [glob -nocomplain -directory $html_dir -tails feeds/*.rss] {
+		dict lappend paths rss /$path }
+
+	foreach dir [glob -nocomplain -directory $html_dir -type d -tails *] {
+		if {[string match .* $dir] || $dir in {feeds summary genodians_manager}} {
+			continue }
+
+		if {[file exists $html_dir/$dir/index]} {
+			dict lappend paths index /$dir/ }
+
+		foreach path [glob -nocomplain -directory $html_dir -tails $dir/*] {
+			switch -regexp -- $path {
+				{/[0-9]{4}-[0-9]{2}-[0-9]{2}-[^.]+$} { dict lappend paths posting /$path }
+				{/[^/]+\.png$}                        { dict lappend paths asset /$path }
+			}
+		}
+	}
+	return $paths
+}
+
+proc random_element { list } {
+	return [lindex $list [expr {int(rand()*[llength $list])}]] }
+
+proc generate_workload { html_dir output args } {
+	array set opt [parse_options {
+		-requests 1000
+		-mix      "index 20 posting 45 rss 10 asset 25"
+		-gzip     80
+		-seed     1
+	} {*}$args]
+
+	expr {srand($opt(-seed))}
+
+	set paths [site_paths $html_dir]
+
+	# drop classes without paths from the mix
+	set mix {}
+	set total_weight 0
+	foreach {class weight} $opt(-mix) {
+		if {![dict exists $paths $class] || ![llength [dict get $paths $class]]} {
+			puts stderr "no paths of class '$class' found in $html_dir"
+			continue
+		}
+		lappend mix $class $weight
+		incr total_weight $weight
+	}
+	if {$total_weight == 0} {
+		puts stderr "no requests to generate"
+		exit 1
+	}
+
+	set fh [open $output "WRONLY CREAT TRUNC"]
+	for {set i 0} {$i < $opt(-requests)} {incr i} {
+		set pick [expr {rand()*$total_weight}]
+		foreach {class weight} $mix {
+			if {$pick < $weight} { break }
+			set pick [expr {$pick - $weight}]
+		}
+		set line "$class [random_element [dict get $paths $class]]"
+		if {rand()*100 < $opt(-gzip)} { append line " gzip" }
+		puts $fh $line
+	}
+	close $fh
+}
+
+
+##
+# Load generation
+##
+
+proc now_us { } { return [clock microseconds] }
+
+proc start_request { id } {
+	global requests next_request client host port opt
+
+	if {$next_request >= [llength $requests]} {
+		close_connection $id
+		return
+	}
+
+	set client($id,request) $next_request
+	set client($id,start)   [now_us]
+	set client($id,buffer)  ""
+	set client($id,timer)   [after $opt(-timeout) [list request_failed $id timeout]]
+	incr next_request
+
+	if {$client($id,sock) ne ""} {
+		send_request $id
+	} else {
+		open_connection $id
+	}
+}
+
+proc open_connection { id } {
+	global client host port
+
+	incr ::connections
+	if {[catch { socket -async $host $port } sock]} {
+		request_failed $id connect
+		return
+	}
+	fconfigure $sock -blocking 0 -translation binary -buffering full
+	set client($id,sock)  $sock
+	set client($id,count) 0
+	fileevent $sock writable [list connected $id]
+}
+
+proc connected { id } {
+	global client
+
+	set sock $client($id,sock)
+	fileevent $sock writable {}
+
+	if {[fconfigure $sock -error] ne ""} {
+		request_failed $id connect
+		return
+	}
+	send_request $id
+}
+
+proc send_request { id } {
+	global client requests host
+
+	lassign [lindex $requests $client($id,request)] class path gzip
+
+	set request "GET $path HTTP/1.1\r\nHost: $host\r\nUser-Agent: http_load\r\n"
+	if {$gzip eq "gzip"} { append request "Accept-Encoding: gzip\r\n" }
+	append request "\r\n"
+
+	set sock $client($id,sock)
+	if {[catch { puts -nonewline $sock $request; flush $sock }]} {
+		request_failed $id send
+		return
+	}
+	fileevent $sock readable [list receive $id]
+}
+
+proc receive { id } {
+	global client
+
+	set sock $client($id,sock)
+	if {[catch { read $sock } data]} {
+		request_failed $id recv
+		return
+	}
+	append client($id,buffer) $data
+
+	set buffer $client($id,buffer)
+	set header_end [string first "\r\n\r\n" $buffer]
+
+	if {$header_end < 0} {
+		if {![eof $sock]} { return }
+
+		# retry once if the server closed the idle persistent connection
+		if {$buffer eq "" && $client($id,count) > 0} {
+			close_connection $id
+			open_connection $id
+			return
+		}
+		request_failed $id closed
+		return
+	}
+
+	set header [string range $buffer 0 [expr {$header_end - 1}]]
+	set body_length [expr {[string length $buffer] - $header_end - 4}]
+
+	if {![regexp {^HTTP/1\.([01]) ([0-9]{3})} $header _ minor status]} {
+		request_failed $id response
+		return
+	}
+
+	set content_length ""
+	regexp -nocase -line {^content-length:\s*([0-9]+)} $header _ content_length
+	if {$minor} {
+		set keep_alive [expr {![regexp -nocase -line {^connection:\s*close} $header]}]
+	} else {
+		set keep_alive [regexp -nocase -line {^connection:\s*keep-alive} $header]
+	}
+
+	# responses without content length are delimited by closing the connection
+	if {$status == 304 || $status == 204} { set content_length 0 }
+	if {$content_length eq ""} {
+		if {![eof $sock]} { return }
+		set keep_alive 0
+	} elseif {$body_length < $content_length} {
+		if {[eof $sock]} { request_failed $id closed }
+		return
+	}
+
+	request_done $id $status $keep_alive
+}
+
+proc record { id status error } {
+	global client requests results
+
+	after cancel $client($id,timer)
+
+	set class [lindex [lindex $requests $client($id,request)] 0]
+	lappend results [list $class [expr {[now_us] - $client($id,start)}] $status $error]
+}
+
+proc request_done { id status keep_alive } {
+	global client
+
+	record $id $status ""
+	incr client($id,count)
+	fileevent $client($id,sock) readable {}
+
+	if {!$keep_alive} { close_connection $id }
+
+	after idle [list start_request $id]
+}
+
+proc request_failed { id error } {
+	global client
+
+	record $id 0 $error
+	close_connection $id
+	after idle [list start_request $id]
+}
+
+proc close_connection { id } {
+	global client
+
+	if {$client($id,sock) ne ""} {
+		catch { close $client($id,sock) }
+		set client($id,sock) ""
+	}
+}
+
+proc percentile { sorted p } {
+	set n [llength $sorted]
+	if {$n == 0} { return 0 }
+	set index [expr {max(0, int(ceil($p*$n)) - 1)}]
+	return [lindex $sorted $index]
+}
+
+proc latency_ms { us } { return [format "%.2f" [expr {$us/1000.0}]] }
+
+proc wait_for_server { host port seconds } {
+	set deadline [expr {[clock seconds] + $seconds}]
+	while {[clock seconds] < $deadline} {
+		if {![catch { socket $host $port } sock]} {
+			fconfigure $sock -translation binary
+			puts -nonewline $sock "HEAD / HTTP/1.0\r\n\r\n"
+			flush $sock
+			set ok [expr {![catch { gets $sock } line] && [string match HTTP/* $line]}]
+			close $sock
+			if {$ok} { return }
+		}
+		after 1000
+	}
+	puts stderr "server $host:$port not responding after $seconds seconds"
+	exit 1
+}
+
+proc run_workload { host_arg port_arg workload args } {
+	global requests next_request client host port opt results connections
+
+	array set opt [parse_options {
+		-connections 8
+		-repeat      1
+		-timeout     10000
+		-wait        0
+		-output      ""
+	} {*}$args]
+
+	set host $host_arg
+	set port $port_arg
+
+	set lines {}
+	set fh [open $workload]
+	foreach line [split [read $fh] "\n"] {
+		if {[llength $line] >= 2} { lappend lines $line } }
+	close $fh
+
+	set requests {}
+	for {set i 0} {$i < $opt(-repeat)} {incr i} {
+		lappend requests {*}$lines }
+
+	if {$opt(-wait) > 0} { wait_for_server $host $port $opt(-wait) }
+
+	set next_request 0
+	set connections  0
+	set results      {}
+
+	set start_us [now_us]
+	for {set id 0} {$id < $opt(-connections)} {incr id} {
+		set client($id,sock)    ""
+		set client($id,request) ""
+		after idle [list start_request $id]
+	}
+
+	# wait until all requests are finished
+	while {[llength $results] < [llength $requests]} { vwait results }
+
+	set elapsed_us [expr {[now_us] - $start_us}]
+
+	report $elapsed_us
+}
+
+proc report { elapsed_us } {
+	global results opt connections requests
+
+	set total [llength $results]
+	set seconds [expr {max($elapsed_us, 1)/1e6}]
+
+	set latencies {}
+	set errors 0
+	set class_latencies [dict create]
+	set class_errors    [dict create]
+	set statuses        [dict create]
+	set error_kinds     [dict create]
+
+	foreach result $results {
+		lassign $result class us status error
+		if {$error ne "" || $status >= 400} {
+			incr errors
+			dict incr class_errors $class
+			dict incr error_kinds [expr {$error ne "" ? $error : "status"}]
+		} else {
+			lappend latencies $us
+			dict lappend class_latencies $class $us
+		}
+		dict incr statuses $status
+	}
+	set latencies [lsort -integer $latencies]
+
+	set rate [format "%.1f" [expr {$total/$seconds}]]
+
+	puts "requests:     $total in [format %.2f $seconds] s, $rate requests/s"
+	puts "connections:  $connections opened by $opt(-connections) clients"
+	puts "latency:      p50 [latency_ms [percentile $latencies 0.5]] ms,\
+	                    p99 [latency_ms [percentile $latencies 0.99]] ms,\
+	                    max [latency_ms [percentile $latencies 1.0]] ms"
+	puts "errors:       $errors ([format %.2f [expr {100.0*$errors/max($total,1)}]]%)\
+	                    [join [lmap {k v} $error_kinds { string cat "$k=$v" }] " "]"
+	puts "status codes: [join [lmap {k v} [lsort -stride 2 $statuses] { string cat "$k=$v" }] " "]"
+
+	set format "%-8s %8s %10s %10s %8s"
+	puts [format $format class requests p50_ms p99_ms errors]
+	foreach class [lsort [dict keys [dict merge $class_latencies $class_errors]]] {
+		set sorted [lsort -integer [expr {[dict exists $class_latencies $class]
+		                                  ? [dict get $class_latencies $class] : {}}]]
+		set class_errors_n [expr {[dict exists $class_errors $class]
+		                          ? [dict get $class_errors $class] : 0}]
+		puts [format $format $class [expr {[llength $sorted] + $class_errors_n}] \
+		                     [latency_ms [percentile $sorted 0.5]] \
+		                     [latency_ms [percentile $sorted 0.99]] $class_errors_n]
+	}
+
+	if {$opt(-output) eq ""} { return }
+
+	set xml "<http_load requests=\"$total\" seconds=\"[format %.3f $seconds]\""
+	append xml " requests_per_second=\"$rate\" clients=\"$opt(-connections)\""
+	append xml " connections=\"$connections\" errors=\"$errors\""
+	append xml " p50_ms=\"[latency_ms [percentile $latencies 0.5]]\""
+	append xml " p99_ms=\"[latency_ms [percentile $latencies 0.99]]\""
+	append xml " max_ms=\"[latency_ms [percentile $latencies 1.0]]\">\n"
+	dict for {class list} $class_latencies {
+		set sorted [lsort -integer $list]
+		append xml "\t<class name=\"$class\" requests=\"[llength $sorted]\""
+		append xml " p50_ms=\"[latency_ms [percentile $sorted 0.5]]\""
+		append xml " p99_ms=\"[latency_ms [percentile $sorted 0.99]]\"/>\n"
+	}
+	dict for {status count} $statuses {
+		append xml "\t<status code=\"$status\" count=\"$count\"/>\n" }
+	dict for {error count} $error_kinds {
+		append xml "\t<error type=\"$error\" count=\"$count\"/>\n" }
+	append xml "</http_load>\n"
+
+	set fh [open $opt(-output) "WRONLY CREAT TRUNC"]
+	puts -nonewline $fh $xml
+	close $fh
+}
+
+
+switch -- [lindex $argv 0] {
+	workload {
+		if {[llength $argv] < 3} { usage }
+		generate_workload {*}[lrange $argv 1 end]
+	}
+	run {
+		if {[llength $argv] < 4} { usage }
+		run_workload {*}[lrange $argv 1 end]
+	}
+	default { usage }
+}
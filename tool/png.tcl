@@ -0,0 +1,486 @@
+#
+# PNG image optimizer used by the static site generator
+#
+# Usage: tclsh tool/png.tcl optimize  <input> <output> <cache-dir>
+#        tclsh tool/png.tcl thumbnail <size> <input> <output> <cache-dir>
+#        tclsh tool/png.tcl prune     <cache-dir> <variant>:<input> ...
+#
+# The 'optimize' command losslessly recompresses the image data and strips
+# ancillary chunks that have no effect on the presentation, e.g., textual
+# meta data and time stamps.
+#
+# The 'thumbnail' command scales the image down such that it fits into a
+# square of <size> pixels. Images that are already small enough are merely
+# optimized. Non-interlaced images of all color types and bit depths are
+# supported. For other images, the thumbnail is the optimized original.
+#
+# Results are stored in <cache-dir> under the CRC32 of the input, which
+# spares the processing of unchanged images. The output is a copy of the
+# cache entry because the cache resides outside of the website. The
+# 'prune' command removes the entries that do not belong to any of the
+# given inputs, the variant being 'opt' for 'optimize' and 'thumb<size>'
+# for 'thumbnail'.
+#
+# The tool relies solely on Tcl's built-in zlib support to avoid the
+# dependency from additional programs on target.
+#
+
+proc read_binary { path } {
+	set fh [open $path "RDONLY"]
+	fconfigure $fh -translation binary
+	set content [read $fh]
+	close $fh
+	return $content
+}
+
+proc write_binary { path content } {
+	set fh [open $path "WRONLY CREAT TRUNC"]
+	fconfigure $fh -translation binary
+	puts -nonewline $fh $content
+	close $fh
+}
+
+set png_signature "\x89PNG\r\n\x1a\n"
+
+# chunks kept by the optimizer, all others are dropped
+set essential_chunks { IHDR PLTE tRNS gAMA cHRM sRGB iCCP IDAT IEND }
+
+
+##
+# Return list of chunks of PNG data, each in the form { type data }
+#
+proc png_chunks { png } {
+	global png_signature
+
+	if {[string range $png 0 7] ne $png_signature} {
+		error "not a PNG image" }
+
+	set chunks { }
+	set offset 8
+	while {$offset + 12 <= [string length $png]} {
+		binary scan $png @${offset}Iua4 length type
+		lappend chunks [list $type [string range $png [expr $offset + 8] \
+		                                              [expr $offset + 7 + $length]]]
+		incr offset [expr $length + 12]
+		if {$type eq "IEND"} { break }
+	}
+	return $chunks
+}
+
+
+proc png_chunk { type data } {
+	return [binary format Ia4 [string length $data] $type]$data[binary format I [zlib crc32 $type$data]]
+}
+
+
+##
+# Assemble PNG from the list of chunks, IDAT chunks are replaced by 'idat'
+#
+proc png_assemble { chunks idat } {
+	global png_signature
+
+	set png $png_signature
+	set idat_written 0
+	foreach chunk $chunks {
+		lassign $chunk type data
+		if {$type eq "IDAT"} {
+			if {!$idat_written} { append png [png_chunk IDAT $idat] }
+			set idat_written 1
+			continue
+		}
+		append png [png_chunk $type $data]
+	}
+	return $png
+}
+
+
+proc chunk_data { chunks type } {
+	set data ""
+	foreach chunk $chunks {
+		if {[lindex $chunk 0] eq $type} { append data [lindex $chunk 1] } }
+	return $data
+}
+
+
+##
+# Lossless recompression
+#
+proc optimize { png } {
+	global essential_chunks
+
+	set chunks { }
+	foreach chunk [png_chunks $png] {
+		if {[lsearch -exact $essential_chunks [lindex $chunk 0]] >= 0} {
+			lappend chunks $chunk } }
+
+	set idat     [chunk_data $chunks IDAT]
+	set stripped [png_assemble $chunks $idat]
+	set opt      [png_assemble $chunks [zlib compress [zlib decompress $idat] 9]]
+
+	if {[string length $opt] < [string length $stripped]} { return $opt }
+	return $stripped
+}
+
+
+##
+# Paeth predictor as defined by the PNG specification
+#
+proc paeth { a b c } {
+	set p  [expr {$a + $b - $c}]
+	set pa [expr {abs($p - $a)}]
+	set pb [expr {abs($p - $b)}]
+	set pc [expr {abs($p - $c)}]
+	if {$pa <= $pb && $pa <= $pc} { return $a }
+	if {$pb <= $pc} { return $b }
+	return $c
+}
+
+
+##
+# Reverse the filter of one scanline
+#
+# The 'row' and 'prev' arguments are lists of byte values, 'bpp' is the
+# number of bytes per complete pixel (at least 1).
+#
+proc unfilter { filter row prev bpp } {
+	set n [llength $row]
+	switch $filter {
+		0 { }
+		1 {
+			for {set i $bpp} {$i < $n} {incr i} {
+				lset row $i [expr {([lindex $row $i] + [lindex $row [expr {$i - $bpp}]]) & 255}] }
+		}
+		2 {
+			for {set i 0} {$i < $n} {incr i} {
+				lset row $i [expr {([lindex $row $i] + [lindex $prev $i]) & 255}] }
+		}
+		3 {
+			for {set i 0} {$i < $n} {incr i} {
+				set a [expr {$i >= $bpp ? [lindex $row [expr {$i - $bpp}]] : 0}]
+				lset row $i [expr {([lindex $row $i] + (($a + [lindex $prev $i]) >> 1)) & 255}] }
+		}
+		4 {
+			for {set i 0} {$i < $n} {incr i} {
+				if {$i >= $bpp} {
+					set a [lindex $row  [expr {$i - $bpp}]]
+					set c [lindex $prev [expr {$i - $bpp}]]
+				} else {
+					set a 0
+					set c 0
+				}
+				lset row $i [expr {([lindex $row $i] + [paeth $a [lindex $prev $i] $c]) & 255}] }
+		}
+		default { error "invalid filter type $filter" }
+	}
+	return $row
+}
+
+
+##
+# Apply filter to one scanline, the inverse of 'unfilter'
+#
+proc filter { filter row prev bpp } {
+	set n   [llength $row]
+	set out { }
+	for {set i 0} {$i < $n} {incr i} {
+		set x [lindex $row $i]
+		set a [expr {$i >= $bpp ? [lindex $row  [expr {$i - $bpp}]] : 0}]
+		set c [expr {$i >= $bpp ? [lindex $prev [expr {$i - $bpp}]] : 0}]
+		set b [lindex $prev $i]
+		switch $filter {
+			0 { lappend out $x }
+			1 { lappend out [expr {($x - $a) & 255}] }
+			2 { lappend out [expr {($x - $b) & 255}] }
+			3 { lappend out [expr {($x - (($a + $b) >> 1)) & 255}] }
+			4 { lappend out [expr {($x - [paeth $a $b $c]) & 255}] }
+		}
+	}
+	return $out
+}
+
+
+##
+# Encode RGB or RGBA rows as PNG image data
+#
+# The filter of each row is chosen by the minimum sum of absolute
+# differences heuristic recommended by the PNG specification.
+#
+proc encode_rows { rows bpp } {
+	set raw  ""
+	set prev [lrepeat [llength [lindex $rows 0]] 0]
+	foreach row $rows {
+		set best_sum -1
+		for {set f 0} {$f < 5} {incr f} {
+			set filtered [filter $f $row $prev $bpp]
+			set sum 0
+			foreach v $filtered { incr sum [expr {$v < 128 ? $v : 256 - $v}] }
+			if {$best_sum < 0 || $sum < $best_sum} {
+				set best_sum $sum
+				set best     [linsert $filtered 0 $f]
+			}
+		}
+		append raw [binary format cu* $best]
+		set prev $row
+	}
+	return [zlib compress $raw 9]
+}
+
+
+##
+# Convert unfiltered scanline to a list of premultiplied RGBA values
+#
+proc rgba_pixels { row color_type depth width palette trns } {
+
+	# unpack samples of less than 8 bits
+	if {$depth < 8} {
+		set samples { }
+		set mask [expr {(1 << $depth) - 1}]
+		foreach byte $row {
+			for {set shift [expr {8 - $depth}]} {$shift >= 0} {incr shift -$depth} {
+				lappend samples [expr {($byte >> $shift) & $mask}] } }
+		set row [lrange $samples 0 [expr {$width - 1}]]
+
+		# scale gray values to 8 bit
+		if {$color_type == 0} {
+			set scaled { }
+			foreach v $row { lappend scaled [expr {$v * 255 / $mask}] }
+			set trns_gray [expr {[llength $trns] ? [lindex $trns 0] * 255 / $mask : -1}]
+			set row $scaled
+		}
+	}
+
+	# reduce samples of 16 bits to their most significant byte
+	if {$depth == 16} {
+		set reduced { }
+		foreach {hi lo} $row { lappend reduced $hi }
+		set row $reduced
+	}
+
+	set pixels { }
+	switch $color_type {
+		0 {
+			if {![info exists trns_gray]} {
+				set trns_gray [expr {[llength $trns] ? [lindex $trns 0] >> ($depth == 16 ? 8 : 0) : -1}] }
+			foreach v $row {
+				if {$v == $trns_gray} { lappend pixels 0 0 0 0 } \
+				else                  { lappend pixels $v $v $v 255 } }
+		}
+		2 {
+			set key [expr {[llength $trns] ? [lmap v $trns { expr {$v >> ($depth == 16 ? 8 : 0)} }] : {}}]
+			foreach {r g b} $row {
+				if {[list $r $g $b] eq $key} { lappend pixels 0 0 0 0 } \
+				else                         { lappend pixels $r $g $b 255 } }
+		}
+		3 {
+			foreach i $row {
+				set a [expr {$i < [llength $trns] ? [lindex $trns $i] : 255}]
+				set base [expr {3*$i}]
+				lappend pixels [expr {[lindex $palette $base] * $a / 255}] \
+				               [expr {[lindex $palette [expr {$base + 1}]] * $a / 255}] \
+				               [expr {[lindex $palette [expr {$base + 2}]] * $a / 255}] $a }
+		}
+		4 {
+			foreach {v a} $row {
+				set v [expr {$v * $a / 255}]
+				lappend pixels $v $v $v $a }
+		}
+		6 {
+			foreach {r g b a} $row {
+				lappend pixels [expr {$r * $a / 255}] [expr {$g * $a / 255}] \
+				               [expr {$b * $a / 255}] $a }
+		}
+	}
+	return $pixels
+}
+
+
+##
+# Scale image down to fit into a square of 'size' pixels
+#
+# Returns an empty string if the image is not supported.
+#
+proc thumbnail { png size } {
+
+	set chunks [png_chunks $png]
+
+	binary scan [chunk_data $chunks IHDR] IuIucucucucucu \
+		width height depth color_type compression filter_method interlace
+
+	if {$interlace != 0} { return "" }
+	if {$width <= $size && $height <= $size} { return "" }
+
+	# bytes per complete pixel, used as filter distance
+	set channels [dict get {0 1 2 3 3 1 4 2 6 4} $color_type]
+	set bpp      [expr {max(1, $channels*$depth/8)}]
+	set stride   [expr {($width*$channels*$depth + 7)/8}]
+
+	binary scan [chunk_data $chunks PLTE] cu* palette
+	binary scan [chunk_data $chunks tRNS] cu* trns
+
+	# tRNS of gray and RGB images contains 16-bit values
+	if {$color_type == 0 || $color_type == 2} {
+		binary scan [chunk_data $chunks tRNS] Su* trns }
+
+	set has_alpha [expr {$color_type == 4 || $color_type == 6 || [llength $trns] > 0}]
+
+	# dimensions of the thumbnail
+	if {$width >= $height} {
+		set tw $size
+		set th [expr {max(1, $height*$size/$width)}]
+	} else {
+		set th $size
+		set tw [expr {max(1, $width*$size/$height)}]
+	}
+
+	# target column of each source column
+	set column_map { }
+	for {set x 0} {$x < $width} {incr x} {
+		lappend column_map [expr {$x*$tw/$width}] }
+
+	set raw    [zlib decompress [chunk_data $chunks IDAT]]
+	set prev   [lrepeat $stride 0]
+	set rows   { }
+	set acc    [lrepeat [expr {4*$tw}] 0]
+	set count  [lrepeat $tw 0]
+	set ty     0
+
+	for {set y 0} {$y < $height} {incr y} {
+		set offset [expr {$y*($stride + 1)}]
+		binary scan $raw @${offset}cu f
+		binary scan $raw @[expr {$offset + 1}]cu$stride row
+		set row  [unfilter $f $row $prev $bpp]
+		set prev $row
+
+		# accumulate premultiplied pixel values per target pixel
+		set x 0
+		foreach {r g b a} [rgba_pixels $row $color_type $depth $width $palette $trns] {
+			set tx [lindex $column_map $x]
+			set i  [expr {4*$tx}]
+			lset acc $i             [expr {[lindex $acc $i] + $r}]
+			lset acc [incr i]       [expr {[lindex $acc $i] + $g}]
+			lset acc [incr i]       [expr {[lindex $acc $i] + $b}]
+			lset acc [incr i]       [expr {[lindex $acc $i] + $a}]
+			lset count $tx          [expr {[lindex $count $tx] + 1}]
+			incr x
+		}
+
+		# emit target row once all of its source rows are accumulated
+		if {($y + 1)*$th/$height > $ty || $y == $height - 1} {
+			set out { }
+			for {set tx 0} {$tx < $tw} {incr tx} {
+				set n [lindex $count $tx]
+				lassign [lrange $acc [expr {4*$tx}] [expr {4*$tx + 3}]] r g b a
+				set a [expr {($a + $n/2)/$n}]
+				if {$a > 0} {
+					set r [expr {min(255, ($r + $n/2)/$n*255/$a)}]
+					set g [expr {min(255, ($g + $n/2)/$n*255/$a)}]
+					set b [expr {min(255, ($b + $n/2)/$n*255/$a)}]
+				}
+				if {$has_alpha} { lappend out $r $g $b $a } \
+				else            { lappend out $r $g $b }
+			}
+			lappend rows $out
+			set acc   [lrepeat [expr {4*$tw}] 0]
+			set count [lrepeat $tw 0]
+			set ty    [expr {($y + 1)*$th/$height}]
+		}
+	}
+
+	set out_bpp [expr {$has_alpha ? 4 : 3}]
+	set ihdr    [binary format IIccccc $tw [llength $rows] 8 [expr {$has_alpha ? 6 : 2}] 0 0 0]
+
+	set out_chunks [list [list IHDR $ihdr]]
+	foreach chunk $chunks {
+		if {[lsearch -exact { gAMA cHRM sRGB iCCP } [lindex $chunk 0]] >= 0} {
+			lappend out_chunks $chunk } }
+	lappend out_chunks [list IDAT ""] [list IEND ""]
+
+	return [png_assemble $out_chunks [encode_rows $rows $out_bpp]]
+}
+
+
+proc usage { } {
+	puts stderr "usage: png.tcl optimize <input> <output> <cache-dir>"
+	puts stderr "       png.tcl thumbnail <size> <input> <output> <cache-dir>"
+	puts stderr "       png.tcl prune <cache-dir> <variant>:<input> ..."
+	exit 1
+}
+
+
+proc cache_name { png variant } {
+	return [format "%08x" [zlib crc32 $png]]-$variant.png
+}
+
+
+##
+# Produce 'output' from 'input' via 'fn', using the cached result if present
+#
+proc with_cache { input output cache_dir variant fn } {
+
+	set png  [read_binary $input]
+	set path [file join $cache_dir [cache_name $png $variant]]
+
+	if {![file exists $path]} {
+		if {[catch { set result [{*}$fn $png] } msg]} {
+			puts stderr "$input: $msg"
+			set result $png
+		}
+		file mkdir $cache_dir
+		write_binary $path $result
+	}
+	file copy -force $path $output
+}
+
+
+##
+# Remove the cache entries not referenced by any '<variant>:<input>' pair
+#
+proc prune_cache { cache_dir references } {
+
+	set referenced [dict create]
+	foreach reference $references {
+		if {![regexp {^([^:]+):(.+)$} $reference -> variant input]} { usage }
+		if {[catch { read_binary $input } png]} { continue }
+		dict set referenced [cache_name $png $variant] 1
+	}
+
+	set removed 0
+	foreach path [glob -nocomplain -directory $cache_dir *.png] {
+		if {![dict exists $referenced [file tail $path]]} {
+			file delete $path
+			incr removed
+		}
+	}
+	puts "image cache: [dict size $referenced] entries referenced, $removed removed"
+}
+
+
+proc thumbnail_or_optimized { size png } {
+	set result [thumbnail $png $size]
+	if {$result eq ""} { return [optimize $png] }
+	return $result
+}
+
+
+switch -- [lindex $argv 0] {
+
+	optimize {
+		if {[llength $argv] != 4} { usage }
+		lassign $argv cmd input output cache_dir
+		with_cache $input $output $cache_dir opt optimize
+	}
+
+	thumbnail {
+		if {[llength $argv] != 5} { usage }
+		lassign $argv cmd size input output cache_dir
+		with_cache $input $output $cache_dir thumb$size \
+		           [list thumbnail_or_optimized $size]
+	}
+
+	prune {
+		if {[llength $argv] < 2} { usage }
+		prune_cache [lindex $argv 1] [lrange $argv 2 end]
+	}
+
+	default { usage }
+}
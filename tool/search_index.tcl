@@ -0,0 +1,300 @@
+#
+# Full-text search index of the static site generator
+#
+# Usage: tclsh tool/search_index.tcl author <content-dir> <author-name> <output>
+#        tclsh tool/search_index.tcl merge <index-dir> <stamp> <partial> ...
+#
+# The 'author' command tokenizes the postings (YYYY-MM-DD-*.txt) of one
+# author into a partial index. The partial index records a CRC-32 of the
+# names and content of the postings. If it matches the current postings,
+# the partial index is kept as is, which spares the tokenization when the
+# site generator rebuilds all targets regardless of their timestamps.
+# Titles, topics, and the text are split into lower-case words of letters
+# and digits, skipping stop words as well as the code blocks, image
+# references, and URLs of the GOSH markup. The score of a word within a
+# posting is the number of occurrences in the text plus TOPIC_WEIGHT per
+# occurrence in the topics and TITLE_WEIGHT per occurrence in the title.
+#
+# The 'merge' command combines the partial indices into the static files
+# of the search page in <index-dir>:
+#
+#   t-<xy>.json  terms starting with <xy>, each with a list of
+#                [<document>, <score>] pairs ordered by descending score
+#   d-<n>.json   documents <n>*DOC_CHUNK to (<n>+1)*DOC_CHUNK-1, each as
+#                [<path>, <title>, <author>, <date>], most recent first
+#
+# A query is thereby answered by fetching the term shard of each word and
+# the document chunks of the best matches. Files are rewritten only if their
+# content changed, obsolete files are removed. The <stamp> file lists the
+# written files along with a CRC-32 of the partial indices. If the CRC
+# is unchanged and all listed files exist, the merge is skipped. The
+# <stamp> file is updated on each merge.
+#
+# The tokenization must match the one of the search page (style/search).
+#
+
+proc usage { } {
+	puts stderr "usage: search_index.tcl author <content-dir> <author-name> <output>"
+	puts stderr "       search_index.tcl merge <index-dir> <stamp> <partial> ..."
+	exit 1
+}
+
+set TITLE_WEIGHT 8
+set TOPIC_WEIGHT 4
+set DOC_CHUNK    256
+
+set stop_words {
+	a about an and are as at be but by can do for from has have how i if in
+	into is it its not of on or so than that the their then there these
+	they this to was we were what when which will with you your
+}
+foreach word $stop_words { set stop($word) 1 }
+
+proc read_text { path } {
+	set fh [open $path "RDONLY"]
+	fconfigure $fh -encoding utf-8
+	set content [read $fh]
+	close $fh
+	return $content
+}
+
+#
+# Write file only if its content changed, keeping the modification time of
+# unchanged files stable
+#
+proc write_text { path content } {
+	if {[file exists $path] && [read_text $path] eq $content} { return 0 }
+
+	set fh [open $path.new "WRONLY CREAT TRUNC"]
+	fconfigure $fh -encoding utf-8
+	puts -nonewline $fh $content
+	close $fh
+	file rename -force $path.new $path
+	return 1
+}
+
+proc words { text } {
+	global stop
+
+	set result {}
+	foreach word [regexp -all -inline {[a-z0-9]+} [string tolower $text]] {
+		if {[string length $word] < 2 || [string length $word] > 32} { continue }
+		if {[info exists stop($word)]} { continue }
+		lappend result $word
+	}
+	return $result
+}
+
+proc add_words { scores_var text weight } {
+	upvar $scores_var scores
+	foreach word [words $text] { dict incr scores $word $weight }
+}
+
+
+##
+# Partial index of one author
+##
+
+proc index_posting { path } {
+	global TITLE_WEIGHT TOPIC_WEIGHT
+
+	set title  ""
+	set text   ""
+	set scores [dict create]
+
+	foreach line [split [read_text $path] "\n"] {
+
+		# the title is the first non-empty line
+		if {$title eq ""} {
+			set title [string trim $line]
+			continue
+		}
+
+		switch -regexp -- $line {
+			{^\| }       { add_words scores [string range $line 2 end] $TOPIC_WEIGHT }
+			{^!}         { }
+			{^\s*\[image } { }
+			default      { append text " " [regsub -all {https?://[^ \]]+} $line ""] }
+		}
+	}
+
+	add_words scores $title $TITLE_WEIGHT
+	add_words scores $text  1
+
+	return [list $title $scores]
+}
+
+proc read_binary { path } {
+	set fh [open $path "RDONLY"]
+	fconfigure $fh -translation binary
+	set content [read $fh]
+	close $fh
+	return $content
+}
+
+# first line of a file, empty if the file does not exist
+proc first_line { path } {
+	if {[catch { open $path "RDONLY" } fh]} { return "" }
+	set line [gets $fh]
+	close $fh
+	return $line
+}
+
+proc index_author { content_dir author_name output } {
+
+	set author [file tail $content_dir]
+	set paths  [lsort [glob -nocomplain -directory $content_dir \
+	                        {[0-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9]-*.txt}]]
+
+	set crc [zlib crc32 [encoding convertto utf-8 $author_name]]
+	foreach path $paths {
+		set crc [zlib crc32 [file tail $path] $crc]
+		set crc [zlib crc32 [read_binary $path] $crc]
+	}
+	set hash [list hash [format "%08x" $crc]]
+
+	if {[first_line $output] ne $hash} {
+
+		set index [list $hash [list author $author $author_name]]
+
+		foreach path $paths {
+			set name [file rootname [file tail $path]]
+			lassign [index_posting $path] title scores
+
+			lappend index [list posting $name [string range $name 0 9] $title $scores]
+		}
+
+		write_text $output "[join $index "\n"]\n"
+	}
+
+	# mark the partial index as up to date even if its content is unchanged
+	file mtime $output [clock seconds]
+}
+
+
+##
+# Merged index
+##
+
+proc json_string { text } {
+	set escaped [string map { \\ \\\\ \" \\\" \n \\n \r \\r \t \\t } $text]
+	return "\"[regsub -all {[\x00-\x1f]} $escaped {}]\""
+}
+
+proc merge { index_dir stamp partials } {
+	global DOC_CHUNK
+
+	file mkdir $index_dir
+
+	set contents {}
+	set crc 0
+	foreach partial $partials {
+		set content [read_text $partial]
+		lappend contents $content
+		set crc [zlib crc32 [encoding convertto utf-8 $content] $crc]
+	}
+	set hash [list hash [format "%08x" $crc] [llength $partials]]
+
+	# skip the merge if the partial indices and the written files are unchanged
+	if {[first_line $stamp] eq $hash} {
+		set fh [open $stamp "RDONLY"]
+		set written [lrange [split [read $fh] "\n"] 1 end]
+		close $fh
+
+		set complete 1
+		foreach file $written {
+			if {$file ne "" && ![file exists $index_dir/$file]} { set complete 0 } }
+
+		if {$complete} {
+			puts "search index: unchanged"
+			file mtime $stamp [clock seconds]
+			return
+		}
+	}
+
+	# documents as list of {date path title author scores}
+	set docs {}
+	foreach content $contents {
+		set author ""
+		set author_name ""
+		foreach entry [split $content "\n"] {
+			switch [lindex $entry 0] {
+				author  { lassign $entry _ author author_name }
+				posting {
+					lassign $entry _ name date title scores
+					lappend docs [list $date $author/$name $title $author_name $scores]
+				}
+			}
+		}
+	}
+
+	# most recent first, which also ranks recent postings first on equal score
+	set docs [lsort -index 0 -decreasing [lsort -index 1 $docs]]
+
+	set written {}
+	set changed 0
+
+	# document chunks
+	for {set first 0} {$first < [llength $docs]} {incr first $DOC_CHUNK} {
+		set entries {}
+		foreach doc [lrange $docs $first [expr {$first + $DOC_CHUNK - 1}]] {
+			lassign $doc date path title author_name
+			lappend entries "\[[json_string $path],[json_string $title],[json_string $author_name],[json_string $date]\]"
+		}
+		set file d-[expr {$first / $DOC_CHUNK}].json
+		incr changed [write_text $index_dir/$file "\[\n[join $entries ",\n"]\n\]\n"]
+		lappend written $file
+	}
+
+	# inverted index grouped by the first two characters of each term
+	set postings [dict create]
+	set id 0
+	foreach doc $docs {
+		dict for {term score} [lindex $doc 4] {
+			dict lappend postings $term [list $id $score] }
+		incr id
+	}
+
+	set shards [dict create]
+	foreach term [lsort [dict keys $postings]] {
+		set pairs {}
+		foreach pair [lsort -integer -index 1 -decreasing [dict get $postings $term]] {
+			lappend pairs "\[[join $pair ,]\]" }
+		dict lappend shards [string range $term 0 1] "[json_string $term]:\[[join $pairs ,]\]"
+	}
+
+	dict for {prefix terms} $shards {
+		set file t-$prefix.json
+		incr changed [write_text $index_dir/$file "\{\n[join $terms ",\n"]\n\}\n"]
+		lappend written $file
+	}
+
+	# remove shards and chunks that are no longer part of the index
+	foreach path [glob -nocomplain -directory $index_dir {[td]-*.json}] {
+		if {[file tail $path] ni $written} {
+			file delete $path
+			incr changed
+		}
+	}
+
+	puts "search index: [llength $docs] postings, [dict size $postings] terms,\
+	      [dict size $shards] shards, $changed files changed"
+
+	set fh [open $stamp "WRONLY CREAT TRUNC"]
+	puts $fh $hash
+	puts $fh [join [lsort $written] "\n"]
+	close $fh
+}
+
+
+switch -- [lindex $argv 0] {
+	author {
+		if {[llength $argv] != 4} { usage }
+		index_author {*}[lrange $argv 1 end]
+	}
+	merge {
+		if {[llength $argv] < 3} { usage }
+		merge [lindex $argv 1] [lindex $argv 2] [lrange $argv 3 end]
+	}
+	default { usage }
+}
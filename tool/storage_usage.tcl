@@ -0,0 +1,137 @@
+#
+# Summary of the space occupied by the file systems of the generate step
+#
+# Usage: tclsh tool/storage_usage.tcl <output> <block-size> <name>=<dir> ...
+#
+# Each directory is traversed without following symbolic links. The output
+# is an XML report with the number of files and their size per directory,
+# to be displayed by the genodians manager. The allocated size rounds each
+# file up to <block-size>, which approximates the resident size within a
+# RAM file system. Regular files with the same size and CRC-32 as a file
+# visited before are accounted as duplicate bytes, which estimates the
+# saving of a deduplicating file system, gzip-compressed siblings of other
+# files as compressed bytes.
+#
+# The checksum is a CRC-32 over the names and content of all files and
+# links, which allows for comparing the outcome of different runs. Hidden
+# files of the generator and the status of the genodians manager are not
+# covered. A summary line per directory is printed to stdout.
+#
+
+proc usage { } {
+	puts stderr "usage: storage_usage.tcl <output> <block-size> <name>=<dir> ..."
+	exit 1
+}
+
+if {[llength $argv] < 3} { usage }
+
+set argv [lassign $argv output block_size]
+if {![string is integer -strict $block_size] || $block_size < 1} { usage }
+
+proc xml_escape { text } {
+	return [string map { & &amp; < &lt; > &gt; \" &quot; } $text]
+}
+
+proc allocated { size } {
+	global block_size
+	return [expr {(($size + $block_size - 1) / $block_size) * $block_size}]
+}
+
+proc read_binary { path } {
+	set fh [open $path "RDONLY"]
+	fconfigure $fh -translation binary
+	set content [read $fh]
+	close $fh
+	return $content
+}
+
+# return true if a file with the same size and content was visited before
+proc duplicate { path size } {
+	global visited
+
+	if {$size == 0 || [catch { read_binary $path } content]} { return 0 }
+
+	set key "$size:[zlib crc32 $content]"
+	if {[dict exists $visited $key]} { return 1 }
+	dict set visited $key 1
+	return 0
+}
+
+# collect usage of directory $dir, whose path relative to the root is $rel
+proc traverse { dir rel checked_dir } {
+	global usage checked
+
+	foreach path [glob -nocomplain -directory $dir * .*] {
+		set name [file tail $path]
+		if {$name eq "." || $name eq ".."} { continue }
+
+		if {[catch { file lstat $path stat }]} { continue }
+
+		set rel_path [string trimleft "$rel/$name" /]
+		set check [expr {$checked_dir && ![string match .* $name]
+		                              && $rel_path ne "genodians_manager"}]
+
+		switch $stat(type) {
+			directory {
+				dict incr usage dirs
+				traverse $path $rel_path $check
+			}
+			link {
+				dict incr usage links
+				if {$check} { lappend checked [list $rel_path link $path] }
+			}
+			file {
+				dict incr usage files
+				dict incr usage bytes     $stat(size)
+				dict incr usage allocated [allocated $stat(size)]
+				if {[file extension $name] eq ".gz"} {
+					dict incr usage compressed $stat(size) }
+				if {[duplicate $path $stat(size)]} {
+					dict incr usage duplicate $stat(size) }
+				if {$check} { lappend checked [list $rel_path file $path] }
+			}
+		}
+	}
+}
+
+proc checksum { } {
+	global checked
+
+	set crc 0
+	foreach entry [lsort -index 0 $checked] {
+		lassign $entry rel_path type path
+		set crc [zlib crc32 "$rel_path\0" $crc]
+		switch $type {
+			link { set crc [zlib crc32 "-> [file readlink $path]\0" $crc] }
+			file { set crc [zlib crc32 [read_binary $path] $crc] }
+		}
+	}
+	return [format "%08x" $crc]
+}
+
+set xml "<storage_usage block_size=\"$block_size\">\n"
+
+foreach arg $argv {
+	if {![regexp {^([^=]+)=(.+)$} $arg dummy name dir]} { usage }
+
+	set usage [dict create dirs 0 files 0 links 0 bytes 0 allocated 0 \
+	                       duplicate 0 compressed 0]
+	set checked {}
+	set visited [dict create]
+	if {[file isdirectory $dir]} { traverse $dir "" 1 }
+	dict set usage checksum [checksum]
+
+	set attributes ""
+	dict for {key value} $usage { append attributes " $key=\"$value\"" }
+
+	append xml "\t<fs name=\"[xml_escape $name]\"$attributes/>\n"
+	puts "storage fs=$name[string map {\" ""} $attributes]"
+}
+
+append xml "</storage_usage>\n"
+
+# replace the report at once, it may be observed by the manager at any time
+set fh [open $output.new "WRONLY CREAT TRUNC"]
+puts -nonewline $fh $xml
+close $fh
+file rename -force $output.new $output
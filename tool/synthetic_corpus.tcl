@@ -0,0 +1,234 @@
+#
+# Generator of a synthetic corpus for scaling tests of the site generator
+#
+# Usage: tclsh tool/synthetic_corpus.tcl [<option> <value> ...] <dir>
+#
+# The tool creates the directories <dir>/content/<author>/ and
+# <dir>/authors/<author>/ for a number of synthetic authors, resembling the
+# layout used when test driving the static site generator. Each content
+# directory contains an author.txt, an author.png, and postings named
+# YYYY-MM-DD-<title>.txt in GOSH syntax with a summary, named paragraphs,
+# lists, code blocks, images, and a line of topics.
+#
+# The sizes are drawn uniformly from the given ranges. With the same seed,
+# the output is identical.
+#
+# Options (defaults in parentheses):
+#
+#   -authors <n>             number of authors (20)
+#   -postings <min>-<max>    postings per author (5-15)
+#   -paragraphs <min>-<max>  paragraphs per posting (4-20)
+#   -words <min>-<max>       words per paragraph (30-120)
+#   -images <min>-<max>      images per posting (0-2)
+#   -image-size <min>-<max>  edge length of the images in pixels (64-512)
+#   -topics <n>              size of the topic vocabulary (40)
+#   -topics-per-posting <min>-<max>  topics of each posting (1-4)
+#   -start-date <YYYY-MM-DD> date of the oldest posting (2019-01-01)
+#   -days <n>                period covered by the postings in days (2000)
+#   -seed <n>                seed of the random-number generator (1)
+#
+
+proc usage { } {
+	puts stderr "usage: synthetic_corpus.tcl \[<option> <value> ...\] <dir>"
+	exit 1
+}
+
+array set opt {
+	-authors            20
+	-postings           5-15
+	-paragraphs         4-20
+	-words              30-120
+	-images             0-2
+	-image-size         64-512
+	-topics             40
+	-topics-per-posting 1-4
+	-start-date         2019-01-01
+	-days               2000
+	-seed               1
+}
+
+if {[llength $argv] % 2 != 1} { usage }
+
+foreach {key value} [lrange $argv 0 end-1] {
+	if {![info exists opt($key)]} { usage }
+	set opt($key) $value
+}
+set root_dir [lindex $argv end]
+
+expr {srand($opt(-seed))}
+
+# random integer within the range given as '<min>-<max>'
+proc random_in { range } {
+	if {![regexp {^([0-9]+)-([0-9]+)$} $range dummy min max] || $min > $max} {
+		puts stderr "invalid range '$range'"
+		exit 1
+	}
+	return [expr {$min + int(rand()*($max - $min + 1))}]
+}
+
+proc random_element { list } {
+	return [lindex $list [expr {int(rand()*[llength $list])}]] }
+
+set vocabulary {
+	genode component session capability sculpt framework kernel driver
+	platform memory quota service client server interface protocol
+	signal thread process address space file system network router
+	package depot runtime config report rom log timer block input
+	framebuffer graphics window manager terminal shell build tool
+	release update feature support hardware device interrupt virtual
+	machine seL4 nova okl4 linux arm riscv x86 boot image library port
+	the a of to and in is for on with as by that this it from be are
+	we our can will which new more also when how into only some other
+}
+
+proc sentence { min max } {
+	global vocabulary
+	set words {}
+	for {set i [random_in $min-$max]} {$i > 0} {incr i -1} {
+		lappend words [random_element $vocabulary] }
+	return "[string totitle [join $words " "]]."
+}
+
+# paragraph of about $n words wrapped at 75 characters
+proc paragraph { n } {
+	set text ""
+	while {[llength $text] < $n} { append text " " [sentence 5 15] }
+
+	set lines {}
+	set line ""
+	foreach word [string trim $text] {
+		if {[string length "$line $word"] > 75} {
+			lappend lines $line
+			set line $word
+		} else {
+			set line [string trim "$line $word"]
+		}
+	}
+	lappend lines $line
+	return [join $lines "\n"]
+}
+
+proc write_file { path content } {
+	set fh [open $path "WRONLY CREAT TRUNC"]
+	fconfigure $fh -translation binary
+	puts -nonewline $fh $content
+	close $fh
+}
+
+proc png_chunk { type data } {
+	set crc [zlib crc32 "$type$data"]
+	return [binary format Ia4a*I [string length $data] $type $data $crc]
+}
+
+# RGB image of $size x $size pixels with a pattern derived from $seed
+proc png_image { size seed } {
+	set r [expr {$seed * 37 % 256}]
+	set g [expr {$seed * 91 % 256}]
+	set b [expr {$seed * 53 % 256}]
+
+	set raw ""
+	for {set y 0} {$y < $size} {incr y} {
+		set row [binary format c 0]
+		for {set x 0} {$x < $size} {incr x} {
+			set noise [expr {int(rand()*16)}]
+			append row [binary format ccc [expr {($r + $x + $noise) % 256}] \
+			                              [expr {($g + $y + $noise) % 256}] \
+			                              [expr {($b + $x*$y) % 256}]]
+		}
+		append raw $row
+	}
+
+	return "\x89PNG\r\n\x1a\n[png_chunk IHDR [binary format IIccccc $size $size 8 2 0 0 0]][png_chunk IDAT [zlib compress $raw 9]][png_chunk IEND {}]"
+}
+
+proc centered { text } {
+	set indent [expr {max(0, (75 - [string length $text]) / 2)}]
+	return "[string repeat " " $indent]$text"
+}
+
+set topics {}
+for {set i 0} {$i < $opt(-topics)} {incr i} {
+	lappend topics "[random_element $vocabulary]$i" }
+
+set start_secs [clock scan $opt(-start-date) -format %Y-%m-%d -gmt 1]
+
+set num_postings 0
+set num_images   0
+
+for {set a 0} {$a < $opt(-authors)} {incr a} {
+
+	set author [format "author%04d" $a]
+	set content_dir $root_dir/content/$author
+	set authors_dir $root_dir/authors/$author
+
+	file mkdir $content_dir $authors_dir
+
+	write_file $authors_dir/name    "Synthetic Author $a\n"
+	write_file $authors_dir/flair   "Contributor\n"
+	write_file $authors_dir/zip_url "https://example.org/$author.zip\n"
+
+	write_file $content_dir/author.txt "[paragraph [random_in $opt(-words)]]\n"
+	write_file $content_dir/author.png [png_image 128 $a]
+
+	set dates {}
+	for {set p [random_in $opt(-postings)]} {$p > 0} {incr p -1} {
+		lappend dates [clock format [expr {$start_secs + 86400*int(rand()*$opt(-days))}] \
+		                            -format %Y-%m-%d -gmt 1] }
+
+	set p 0
+	foreach date [lsort $dates] {
+		set title [sentence 3 8]
+		set name "$date-[string tolower [join [lrange [string trimright $title .] 0 3] -]]-$p"
+
+		set text "\n[centered [string trimright $title .]]\n\n"
+		append text [paragraph [random_in $opt(-words)]] "\n"
+
+		set paragraphs [random_in $opt(-paragraphs)]
+		set images     [random_in $opt(-images)]
+		for {set i 1} {$i < $paragraphs} {incr i} {
+
+			switch [expr {$i % 6}] {
+				2 {
+					set heading [string trimright [sentence 2 5] .]
+					append text "\n\n$heading\n[string repeat - [string length $heading]]\n"
+				}
+				3 {
+					append text "\n"
+					for {set j [random_in 2-5]} {$j > 0} {incr j -1} {
+						append text "\n* [sentence 4 10]" }
+					append text "\n"
+				}
+				5 {
+					append text "\n"
+					for {set j [random_in 3-10]} {$j > 0} {incr j -1} {
+						append text "\n! [join [lrange [sentence 2 6] 0 end] _]();" }
+					append text "\n"
+				}
+			}
+
+			if {$images > 0 && $i % 4 == 1} {
+				set image "$name-img$images"
+				write_file $content_dir/$image.png \
+				           [png_image [random_in $opt(-image-size)] $num_images]
+				append text "\n\[image $image\]\n"
+				incr images -1
+				incr num_images
+			}
+
+			append text "\n" [paragraph [random_in $opt(-words)]] "\n"
+		}
+
+		set posting_topics {}
+		for {set t [random_in $opt(-topics-per-posting)]} {$t > 0} {incr t -1} {
+			set topic [random_element $topics]
+			if {$topic ni $posting_topics} { lappend posting_topics $topic }
+		}
+		append text "\n| [join $posting_topics " "]\n"
+
+		write_file $content_dir/$name.txt $text
+		incr p
+		incr num_postings
+	}
+}
+
+puts "generated $opt(-authors) authors, $num_postings postings, and $num_images images in $root_dir"
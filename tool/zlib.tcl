@@ -0,0 +1,54 @@
+#
+# Compression utilities used by the static site generator
+#
+# Usage: tclsh tool/zlib.tcl gzip  <input> <output>
+#        tclsh tool/zlib.tcl crc32 <input>
+#
+# The tool relies solely on Tcl's built-in zlib support to avoid the
+# dependency from additional programs on target.
+#
+
+proc read_binary { path } {
+	set fh [open $path "RDONLY"]
+	fconfigure $fh -translation binary
+	set content [read $fh]
+	close $fh
+	return $content
+}
+
+#
+# Write file only if its content changed, keeping the modification time of
+# unchanged files stable
+#
+proc write_binary { path content } {
+	if {[file exists $path] && [read_binary $path] eq $content} { return }
+
+	set fh [open $path "WRONLY CREAT TRUNC"]
+	fconfigure $fh -translation binary
+	puts -nonewline $fh $content
+	close $fh
+}
+
+proc usage { } {
+	puts stderr "usage: zlib.tcl gzip <input> <output> | crc32 <input>"
+	exit 1
+}
+
+switch -- [lindex $argv 0] {
+
+	gzip {
+		if {[llength $argv] != 3} { usage }
+
+		# the default gzip header lacks a time stamp, keeping the output stable
+		write_binary [lindex $argv 2] \
+		             [zlib gzip [read_binary [lindex $argv 1]] -level 9]
+	}
+
+	crc32 {
+		if {[llength $argv] != 2} { usage }
+
+		puts [format "%08x" [zlib crc32 [read_binary [lindex $argv 1]]]]
+	}
+
+	default { usage }
+}